@@ -0,0 +1,19 @@
+#pragma once
+
+/** Benchmark clock
+ * Timestamps of the benchmarks and tools, from the monotonic clock like the real-time loop
+ * (@see rtloop.c), so a step of the wall clock does not corrupt a measurement.
+ */
+
+#include <time.h>
+
+/**
+ * @brief Reads a monotonic timestamp.
+ * @return Time in nanoseconds.
+ */
+static inline double bench_now_ns(void)
+{
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((double)ts.tv_sec * 1e9) + (double)ts.tv_nsec;
+}
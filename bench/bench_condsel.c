@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include "bench_clock.h"
+#include "condsel.h"
+#include "posdet.h"
+
+/* Number of calls per measurement and size of the input pattern. */
+#define BENCH_ITERATIONS  20000000UL
+#define BENCH_PATTERN     256U
+
+/* Inputs and condition indices, precomputed so the loop only measures the selector. */
+static CondSel_In inputs[BENCH_PATTERN];
+static uint8_t indices[BENCH_PATTERN];
+
+/**
+ * @brief Position check of the function table, always ok like the production stubs.
+ */
+static bool position_ok(void *context)
+{
+    (void)context;
+    return true;
+}
+
+/**
+ * @brief Fills the input pattern with pseudo-random values.
+ */
+static void init_pattern(void)
+{
+    uint32_t seed = 1U;
+
+    for (uint32_t i = 0U; i < BENCH_PATTERN; i++)
+    {
+        seed = (seed * 1103515245U) + 12345U;
+        inputs[i].call_pending_below = ((seed >> 16) & 1U) != 0U;
+        inputs[i].call_pending_same = ((seed >> 17) & 1U) != 0U;
+        inputs[i].call_pending_above = ((seed >> 18) & 1U) != 0U;
+        inputs[i].door_closed = ((seed >> 19) & 1U) != 0U;
+        inputs[i].door_open = !inputs[i].door_closed;
+        indices[i] = (uint8_t)((seed >> 20) & 7U);
+    }
+}
+
+/**
+ * @brief Measures CondSel_calc with the global PosDet binding.
+ * @param[out] sink Receives the number of active results.
+ * @return Nanoseconds per call.
+ */
+static double bench_global(unsigned long *sink)
+{
+    unsigned long active = 0UL;
+    double start = bench_now_ns();
+
+    for (unsigned long i = 0UL; i < BENCH_ITERATIONS; i++)
+    {
+        uint32_t k = (uint32_t)i & (BENCH_PATTERN - 1U);
+        active += CondSel_calc(false, indices[k], inputs[k]) ? 1UL : 0UL;
+    }
+
+    *sink += active;
+    return (bench_now_ns() - start) / (double)BENCH_ITERATIONS;
+}
+
+/**
+ * @brief Measures CondSel_calc_ops with a PosDet function table.
+ * @param[out] sink Receives the number of active results.
+ * @return Nanoseconds per call.
+ */
+static double bench_ops(unsigned long *sink)
+{
+    const PosDet_Ops posdet = {position_ok, position_ok, NULL};
+    unsigned long active = 0UL;
+    double start = bench_now_ns();
+
+    for (unsigned long i = 0UL; i < BENCH_ITERATIONS; i++)
+    {
+        uint32_t k = (uint32_t)i & (BENCH_PATTERN - 1U);
+        active += CondSel_calc_ops(&posdet, false, indices[k], inputs[k]) ? 1UL : 0UL;
+    }
+
+    *sink += active;
+    return (bench_now_ns() - start) / (double)BENCH_ITERATIONS;
+}
+
+int main(void)
+{
+    unsigned long sink = 0UL;
+
+    init_pattern();
+
+    /* Warm up caches and branch predictors. */
+    (void)bench_global(&sink);
+
+#if defined(POSDET_BINDING_INLINE)
+    const char *binding = "inline";
+#else
+    const char *binding = "link-time";
+#endif
+
+    printf("CondSel_calc     (%s PosDet): %6.2f ns/call\n", binding, bench_global(&sink));
+    printf("CondSel_calc_ops (function table): %6.2f ns/call\n", bench_ops(&sink));
+    printf("(active results: %lu)\n", sink);
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include "bench_clock.h"
+#include "condsel.h"
+#include "controller.h"
+#include "lockstep.h"
+
+/* Number of cycles per measurement and size of the sensor pattern. */
+#define BENCH_CYCLES   20000000UL
+#define BENCH_PATTERN  256U
+
+/* Sensor words, precomputed so the loop only measures the controller. */
+static uint8_t sensors[BENCH_PATTERN];
+
+/**
+ * @brief Fills the sensor pattern with pseudo-random words, held for a few cycles each.
+ */
+static void init_pattern(void)
+{
+    uint32_t seed = 1U;
+
+    for (uint32_t i = 0U; i < BENCH_PATTERN; i++)
+    {
+        if ((i & 3U) == 0U)
+        {
+            seed = (seed * 1103515245U) + 12345U;
+        }
+        sensors[i] = (uint8_t)((seed >> 16) & 0x7FU);
+    }
+}
+
+/**
+ * @brief Measures SeqNet_loop with the decoded instruction and a separate condition evaluation.
+ * @param[out] sink Receives the number of move requests.
+ * @return Nanoseconds per cycle.
+ */
+static double bench_split(unsigned long *sink)
+{
+    unsigned long moves = 0UL;
+    uint8_t condition = 0U;
+    SeqNet_init();
+    double start = bench_now_ns();
+
+    for (unsigned long i = 0UL; i < BENCH_CYCLES; i++)
+    {
+        SeqNet_Out out = SeqNet_loop(condition);
+        moves += (out.req_move_up || out.req_move_down) ? 1UL : 0UL;
+        condition = CondSel_eval_packed(out.cond_inv, out.cond_sel, sensors[(uint32_t)i & (BENCH_PATTERN - 1U)]);
+    }
+
+    *sink += moves;
+    return (bench_now_ns() - start) / (double)BENCH_CYCLES;
+}
+
+/**
+ * @brief Measures Controller_step, reading the move requests from the instruction word.
+ * @param[out] sink Receives the number of move requests.
+ * @return Nanoseconds per cycle.
+ */
+static double bench_fused(unsigned long *sink)
+{
+    unsigned long moves = 0UL;
+    uint8_t sensed = 0U;
+    Controller controller;
+    Controller_init(&controller);
+    double start = bench_now_ns();
+
+    for (unsigned long i = 0UL; i < BENCH_CYCLES; i++)
+    {
+        uint16_t instruction = Controller_step(&controller, sensed);
+        moves += (SEQNET_MOVE_UP(instruction) || SEQNET_MOVE_DOWN(instruction)) ? 1UL : 0UL;
+        sensed = sensors[(uint32_t)i & (BENCH_PATTERN - 1U)];
+    }
+
+    *sink += moves;
+    return (bench_now_ns() - start) / (double)BENCH_CYCLES;
+}
+
+/**
+ * @brief Measures two Controller_step channels run one after the other, compared every cycle.
+ * @param[out] sink Receives the number of move requests.
+ * @return Nanoseconds per cycle.
+ */
+static double bench_serial(unsigned long *sink)
+{
+    unsigned long moves = 0UL;
+    uint8_t sensed = 0U;
+    Controller channel_a;
+    Controller channel_b;
+    Controller_init(&channel_a);
+    Controller_init(&channel_b);
+    double start = bench_now_ns();
+
+    for (unsigned long i = 0UL; i < BENCH_CYCLES; i++)
+    {
+        uint16_t instruction = Controller_step(&channel_a, sensed);
+        if ((Controller_step(&channel_b, sensed) != instruction) || (channel_a.state.pc != channel_b.state.pc))
+        {
+            instruction = LOCKSTEP_SAFE_STOP;
+        }
+        moves += (SEQNET_MOVE_UP(instruction) || SEQNET_MOVE_DOWN(instruction)) ? 1UL : 0UL;
+        sensed = sensors[(uint32_t)i & (BENCH_PATTERN - 1U)];
+    }
+
+    *sink += moves;
+    return (bench_now_ns() - start) / (double)BENCH_CYCLES;
+}
+
+/**
+ * @brief Measures Lockstep_step, both channels of one redundant controller.
+ * @param[out] sink Receives the number of move requests.
+ * @return Nanoseconds per cycle.
+ */
+static double bench_lockstep(unsigned long *sink)
+{
+    unsigned long moves = 0UL;
+    uint8_t sensed = 0U;
+    Lockstep lockstep;
+    Lockstep_init(&lockstep);
+    double start = bench_now_ns();
+
+    for (unsigned long i = 0UL; i < BENCH_CYCLES; i++)
+    {
+        uint16_t instruction = Lockstep_step(&lockstep, sensed);
+        moves += (SEQNET_MOVE_UP(instruction) || SEQNET_MOVE_DOWN(instruction)) ? 1UL : 0UL;
+        sensed = sensors[(uint32_t)i & (BENCH_PATTERN - 1U)];
+    }
+
+    *sink += moves;
+    return (bench_now_ns() - start) / (double)BENCH_CYCLES;
+}
+
+int main(void)
+{
+    unsigned long sink = 0UL;
+
+    init_pattern();
+
+    /* Warm up caches and branch predictors. */
+    (void)bench_split(&sink);
+
+    double single = bench_fused(&sink);
+    double serial = bench_serial(&sink);
+    double lockstep = bench_lockstep(&sink);
+
+    printf("SeqNet_loop + CondSel_eval_packed: %6.2f ns/cycle\n", bench_split(&sink));
+    printf("Controller_step                  : %6.2f ns/cycle\n", single);
+    printf("2x Controller_step, compared     : %6.2f ns/cycle (%+.0f%%)\n", serial, ((serial / single) - 1.0) * 100.0);
+    printf("Lockstep_step                    : %6.2f ns/cycle (%+.0f%%)\n", lockstep, ((lockstep / single) - 1.0) * 100.0);
+    printf("(move requests: %lu)\n", sink);
+
+    return 0;
+}
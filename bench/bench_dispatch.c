@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <string.h>
+#include "bench_clock.h"
+#include "condsel.h"
+#include "seqnet.h"
+
+/* Number of decisions per measurement. */
+#define BENCH_ITERATIONS  20000000UL
+
+/* Addresses of the built-in program. */
+#define ADDR_IDLE        1U
+#define ADDR_CLOSE_DOOR  4U
+#define ADDR_CHOOSE_DIR  6U
+#define ADDR_MOVE_UP     7U
+#define ADDR_MOVE_DOWN   9U
+#define ADDR_ARRIVED     11U
+
+/* Free words behind the built-in program, holding the chain of single checks. */
+#define ADDR_CHAIN       40U
+
+/* Condition selector indices of the single checks. */
+#define COND(index)      ((uint16_t)((uint16_t)(index) << SEQNET_SHIFT_COND_SEL))
+#define COND_CALL_BELOW  COND(1U)
+#define COND_CALL_SAME   COND(2U)
+#define COND_CALL_ABOVE  COND(3U)
+#define COND_ALWAYS      ((uint16_t)(SEQNET_FIELD_INV | COND(7U)))
+
+/* Sensor word of a car standing with the door closed, without the call bits. */
+#define SENSORS_BASE     (CONDSEL_IN_DOOR_CLOSED | CONDSEL_IN_ELEVATOR_POS_OK | CONDSEL_IN_DOOR_POS_OK)
+
+/** One decision of CHOOSE_DIRECTION. */
+typedef struct {
+    const char *name;
+    uint8_t calls;
+} Decision;
+
+static const Decision decisions[] = {
+    {"call above", CONDSEL_IN_ABOVE},
+    {"call below", CONDSEL_IN_BELOW},
+    {"call same",  CONDSEL_IN_SAME},
+    {"no call",    0U},
+};
+
+#define DECISION_COUNT  (sizeof(decisions) / sizeof(decisions[0]))
+
+static uint16_t dispatch_image[SEQNET_PROG_MEM_SIZE];
+static uint16_t chain_image[SEQNET_PROG_MEM_SIZE];
+
+/**
+ * @brief Builds the built-in program and a copy with CHOOSE_DIRECTION as the chain of single checks
+ *        the dispatch replaced, in the order of the original program.
+ */
+static void init_images(void)
+{
+    memcpy(dispatch_image, SeqNet_program(), sizeof(dispatch_image));
+    memcpy(chain_image, SeqNet_program(), sizeof(chain_image));
+
+    chain_image[ADDR_CLOSE_DOOR] = (uint16_t)((chain_image[ADDR_CLOSE_DOOR] & ~SEQNET_FIELD_JUMP_ADDR) | ADDR_CHAIN);
+    chain_image[ADDR_CHAIN]      = (uint16_t)(COND_CALL_ABOVE | ADDR_MOVE_UP);
+    chain_image[ADDR_CHAIN + 1U] = (uint16_t)(COND_CALL_BELOW | ADDR_MOVE_DOWN);
+    chain_image[ADDR_CHAIN + 2U] = (uint16_t)(COND_CALL_SAME | ADDR_ARRIVED);
+    chain_image[ADDR_CHAIN + 3U] = (uint16_t)(COND_ALWAYS | ADDR_IDLE);
+}
+
+/**
+ * @brief Checks whether the program counter reached one of the states CHOOSE_DIRECTION decides on.
+ */
+static bool decided(const uint8_t pc)
+{
+    return (pc == ADDR_MOVE_UP) || (pc == ADDR_MOVE_DOWN) || (pc == ADDR_ARRIVED) || (pc == ADDR_IDLE);
+}
+
+/**
+ * @brief Runs one decision, from the first cycle in CHOOSE_DIRECTION until a decided state is reached.
+ * @param[in]  image    Program image to run.
+ * @param[in]  entry    Address of CHOOSE_DIRECTION in the image.
+ * @param[in]  sensors  Packed sensor word, constant during the decision.
+ * @param[out] target   Receives the decided state.
+ * @return Number of cycles to the decision.
+ */
+static uint32_t decide(const uint16_t *image, const uint8_t entry, const uint8_t sensors, uint8_t *target)
+{
+    SeqNet_State state = {entry};
+    uint16_t instruction = image[entry];
+    uint32_t cycles = 0U;
+
+    do
+    {
+        uint8_t condition = CondSel_eval_packed(SEQNET_COND_INV(instruction), SEQNET_COND_SEL(instruction), sensors);
+        instruction = SeqNet_step_image(image, &state, condition);
+        cycles++;
+    } while (!decided(state.pc));
+
+    *target = state.pc;
+    return cycles;
+}
+
+/**
+ * @brief Measures the decisions of a program image, cycling through all keys.
+ * @param[in]  image  Program image to run.
+ * @param[in]  entry  Address of CHOOSE_DIRECTION in the image.
+ * @param[out] sink   Receives the sum of the decided states.
+ * @return Nanoseconds per decision.
+ */
+static double bench_image(const uint16_t *image, const uint8_t entry, unsigned long *sink)
+{
+    unsigned long sum = 0UL;
+    double start = bench_now_ns();
+
+    for (unsigned long i = 0UL; i < BENCH_ITERATIONS; i++)
+    {
+        uint8_t target;
+        (void)decide(image, entry, (uint8_t)(SENSORS_BASE | decisions[i % DECISION_COUNT].calls), &target);
+        sum += target;
+    }
+
+    *sink += sum;
+    return (bench_now_ns() - start) / (double)BENCH_ITERATIONS;
+}
+
+int main(void)
+{
+    unsigned long sink = 0UL;
+
+    init_images();
+
+    printf("Cycles to decision of CHOOSE_DIRECTION, counted from its first cycle:\n");
+    printf("%-12s %12s %12s\n", "", "check chain", "dispatch");
+    for (uint32_t i = 0U; i < DECISION_COUNT; i++)
+    {
+        uint8_t sensors = (uint8_t)(SENSORS_BASE | decisions[i].calls);
+        uint8_t chain_target;
+        uint8_t dispatch_target;
+        uint32_t chain_cycles = decide(chain_image, ADDR_CHAIN, sensors, &chain_target);
+        uint32_t dispatch_cycles = decide(dispatch_image, ADDR_CHOOSE_DIR, sensors, &dispatch_target);
+
+        printf("%-12s %12u %12u%s\n", decisions[i].name, (unsigned)chain_cycles, (unsigned)dispatch_cycles,
+               (chain_target == dispatch_target) ? "" : "  (different state)");
+    }
+
+    /* Warm up caches and branch predictors. */
+    (void)bench_image(dispatch_image, ADDR_CHOOSE_DIR, &sink);
+
+    printf("check chain: %6.2f ns/decision\n", bench_image(chain_image, ADDR_CHAIN, &sink));
+    printf("dispatch:    %6.2f ns/decision\n", bench_image(dispatch_image, ADDR_CHOOSE_DIR, &sink));
+    printf("(decided states: %lu)\n", sink);
+
+    return 0;
+}
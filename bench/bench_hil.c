@@ -0,0 +1,134 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "bench_clock.h"
+#include "hil.h"
+
+/* Rigs per run, cars per rig and ticks per rig. */
+#define BENCH_MAX_RIGS  16U
+#define BENCH_CARS      16U
+#define BENCH_TICKS     20000U
+
+/* One rig: a gateway thread and a plant thread connected by one link. */
+typedef struct {
+    char address[64];
+    pthread_t gateway;
+    HIL_Stats gateway_stats;
+    HIL_Stats plant_stats;
+    int gateway_result;
+    int plant_result;
+} Rig;
+
+/**
+ * @brief Gateway side of a rig.
+ */
+static void *run_gateway(void *context)
+{
+    Rig *rig = (Rig *)context;
+    HIL_Link link;
+
+    rig->gateway_result = HIL_serve(&link, rig->address, HIL_TIMEOUT_MS);
+    if (rig->gateway_result == 0)
+    {
+        rig->gateway_result = HIL_run_gateway(&link, &rig->gateway_stats);
+    }
+    HIL_close(&link);
+    return NULL;
+}
+
+/**
+ * @brief Plant side of a rig, feeds a fixed sensor pattern and ignores the instructions.
+ */
+static void *run_plant(void *context)
+{
+    Rig *rig = (Rig *)context;
+    HIL_Link link;
+    uint8_t sensors[BENCH_CARS];
+    uint16_t outputs[BENCH_CARS];
+
+    rig->plant_result = HIL_connect(&link, rig->address, HIL_TIMEOUT_MS);
+    if (rig->plant_result == 0)
+    {
+        rig->plant_result = HIL_hello(&link, BENCH_CARS, &rig->plant_stats);
+    }
+
+    for (uint64_t tick = 0U; (tick < BENCH_TICKS) && (rig->plant_result == 0); tick++)
+    {
+        for (uint32_t car = 0U; car < BENCH_CARS; car++)
+        {
+            sensors[car] = (uint8_t)((tick + car) & 0x7FU);
+        }
+        rig->plant_result = HIL_exchange(&link, tick, sensors, outputs, BENCH_CARS, &rig->plant_stats);
+    }
+
+    if (rig->plant_result == 0)
+    {
+        rig->plant_result = HIL_bye(&link);
+    }
+    HIL_close(&link);
+    return NULL;
+}
+
+/**
+ * @brief Runs rigs side by side and prints the round trips seen by the plants.
+ */
+static int run(const char *transport, const unsigned rigs)
+{
+    static Rig rig[BENCH_MAX_RIGS];
+    pthread_t plants[BENCH_MAX_RIGS];
+
+    double start = bench_now_ns();
+    for (unsigned i = 0U; i < rigs; i++)
+    {
+        memset(&rig[i], 0, sizeof(rig[i]));
+        /* Socket files go to /tmp, shared memory names are flat. */
+        (void)snprintf(rig[i].address, sizeof(rig[i].address), "%s%s/elevator_bench_hil_%d_%u", transport,
+                       (strcmp(transport, "unix:") == 0) ? "/tmp" : "", (int)getpid(), i);
+        (void)pthread_create(&rig[i].gateway, NULL, run_gateway, &rig[i]);
+        (void)pthread_create(&plants[i], NULL, run_plant, &rig[i]);
+    }
+
+    uint64_t p50_max = 0U;
+    uint64_t p99_max = 0U;
+    uint64_t ticks = 0U;
+    for (unsigned i = 0U; i < rigs; i++)
+    {
+        (void)pthread_join(plants[i], NULL);
+        (void)pthread_join(rig[i].gateway, NULL);
+        if ((rig[i].plant_result != 0) || (rig[i].gateway_result != 0))
+        {
+            fprintf(stderr, "Rig %u failed: plant %d, gateway %d\n", i, rig[i].plant_result, rig[i].gateway_result);
+            return 1;
+        }
+
+        uint64_t p50 = Histo_percentile(&rig[i].plant_stats.rtt, 50.0);
+        uint64_t p99 = Histo_percentile(&rig[i].plant_stats.rtt, 99.0);
+        p50_max = (p50 > p50_max) ? p50 : p50_max;
+        p99_max = (p99 > p99_max) ? p99 : p99_max;
+        ticks += rig[i].plant_stats.ticks;
+    }
+    double elapsed = bench_now_ns() - start;
+
+    printf("%-5s rigs=%2u  %9.0f ticks/s  rtt p50<=%6llu ns  p99<=%7llu ns (worst rig)\n",
+           transport, rigs, (double)ticks * 1e9 / elapsed,
+           (unsigned long long)p50_max, (unsigned long long)p99_max);
+    return 0;
+}
+
+int main(void)
+{
+    static const unsigned rig_counts[] = {1U, 4U, 16U};
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    printf("%u cars per rig, %u ticks per rig, %ld CPUs\n", BENCH_CARS, BENCH_TICKS, cpus);
+    for (unsigned i = 0U; i < (sizeof(rig_counts) / sizeof(rig_counts[0])); i++)
+    {
+        if ((run("unix:", rig_counts[i]) != 0) || (run("shm:", rig_counts[i]) != 0))
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
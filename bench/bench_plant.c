@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench_clock.h"
+#include "elevator_abi.h"
+#include "plant.h"
+
+/* Simulated cars and time. */
+#define BENCH_CARS      4096U
+#define BENCH_FLOORS    6U
+#define BENCH_SECONDS   600U
+
+/* Control cycle, the plant is integrated with the same step. */
+#define BENCH_DT        0.01f
+
+/* Mean number of control cycles between two calls of a car. */
+#define BENCH_CALL_INTERVAL  2000U
+
+int main(void)
+{
+    Plant plant;
+    Plant_Config config;
+    Plant_default_config(&config, BENCH_FLOORS);
+    if (Plant_create(&plant, BENCH_CARS, &config) != 0)
+    {
+        fprintf(stderr, "Plant_create failed\n");
+        return 1;
+    }
+
+    ElevBatch *batch = elev_batch_create(BENCH_CARS);
+    uint32_t *calls = calloc(BENCH_CARS, sizeof(uint32_t));
+    uint8_t *sensors = malloc(BENCH_CARS);
+    uint16_t *outputs = malloc(BENCH_CARS * sizeof(uint16_t));
+    if ((batch == NULL) || (calls == NULL) || (sensors == NULL) || (outputs == NULL))
+    {
+        fprintf(stderr, "Allocation failed\n");
+        return 1;
+    }
+
+    const uint32_t cycles = (uint32_t)((float)BENCH_SECONDS / BENCH_DT);
+    uint32_t seed = 1U;
+    uint64_t served = 0U;
+    double plant_ns = 0.0;
+    double start = bench_now_ns();
+
+    for (uint32_t cycle = 0U; cycle < cycles; cycle++)
+    {
+        for (uint32_t car = 0U; car < BENCH_CARS; car++)
+        {
+            seed = (seed * 1103515245U) + 12345U;
+            if (((seed >> 16) % BENCH_CALL_INTERVAL) == 0U)
+            {
+                calls[car] |= 1U << ((seed >> 8) % BENCH_FLOORS);
+            }
+            sensors[car] = Plant_sense(&plant, car, calls[car]);
+        }
+
+        (void)elev_batch_step(batch, sensors, outputs, 1U);
+
+        for (uint32_t car = 0U; car < BENCH_CARS; car++)
+        {
+            if (((outputs[car] & ELEV_OUT_RESET_CALL) != 0U) && Plant_is_level(&plant, car))
+            {
+                uint32_t bit = 1U << Plant_floor(&plant, car);
+                served += ((calls[car] & bit) != 0U) ? 1U : 0U;
+                calls[car] &= ~bit;
+            }
+            Plant_command(&plant, car, outputs[car]);
+        }
+
+        double plant_start = bench_now_ns();
+        Plant_step(&plant, BENCH_DT);
+        plant_ns += bench_now_ns() - plant_start;
+    }
+
+    double total_ns = bench_now_ns() - start;
+    double car_cycles = (double)cycles * (double)BENCH_CARS;
+
+    printf("%u cars, %u s simulated in %.2f s (%.0fx real time), %llu calls served\n",
+           BENCH_CARS, BENCH_SECONDS, total_ns / 1e9, (double)BENCH_SECONDS * 1e9 / total_ns,
+           (unsigned long long)served);
+    printf("Closed loop: %6.2f ns/car-cycle\n", total_ns / car_cycles);
+    printf("Plant_step:  %6.2f ns/car-cycle\n", plant_ns / car_cycles);
+
+    free(outputs);
+    free(sensors);
+    free(calls);
+    elev_batch_destroy(batch);
+    Plant_destroy(&plant);
+    return 0;
+}
@@ -0,0 +1,46 @@
+#include <chrono>
+#include <cstdio>
+
+#include "scenario.hpp"
+
+using elevator::Car;
+using elevator::Scenario;
+using elevator::Scheduler;
+
+/* Simulated cars and scenarios, the scenarios share the cars. */
+static constexpr uint32_t kCars = 1000U;
+static constexpr uint32_t kScenarios = 50000U;
+static constexpr uint32_t kFloors = 6U;
+static constexpr uint64_t kMaxCycles = 10000000U;
+
+/* Waits a while, calls the car to a floor and waits until the call is served. */
+static Scenario passenger(Car car, uint32_t n, uint64_t *resumes) {
+    uint8_t floor = (uint8_t)((n * 7U) % kFloors);
+    co_await car.wait_cycles((n * 131U) % 20000U);
+    (*resumes)++;
+    car.call(floor);
+    co_await car.wait_served(floor);
+    (*resumes)++;
+    co_await car.wait_door_open();
+    (*resumes)++;
+}
+
+int main() {
+    Plant_Config config;
+    Plant_default_config(&config, kFloors);
+    Scheduler scheduler(kCars, config);
+    uint64_t resumes = 0U;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t n = 0U; n < kScenarios; n++) {
+        scheduler.spawn(passenger(scheduler.car(n % kCars), n, &resumes));
+    }
+    uint64_t cycles = scheduler.run(kMaxCycles);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%u scenarios on %u cars: %llu cycles in %.2f s, %u unfinished\n",
+                kScenarios, kCars, (unsigned long long)cycles, seconds, scheduler.live());
+    std::printf("%llu resumes, %6.2f ns per car-cycle including the scheduling\n",
+                (unsigned long long)resumes, seconds * 1e9 / ((double)cycles * kCars));
+    return 0;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+/** Call ingestion queue module
+ * This component collects hall and car calls from any number of producer threads (button
+ * handlers, simulated input sources) and hands them over to the single control loop.
+ * Posting a call sets the bit of the floor in an atomic bitmap, so it is lock-free and never
+ * allocates. The control loop drains the bitmap with one atomic exchange per cycle and
+ * acknowledges every served call to the producers.
+ *
+ * Per floor, one word holds the posted flag of the floor (bit 0) and its generation, the number
+ * of drains that took a call of the floor (times 2). Posting sets the flag and reads the
+ * generation in one atomic operation, so the ticket of a call is the generation of the drain that
+ * takes it over. The ack stores the generation of the last drain as the served generation, and
+ * serves exactly the calls taken over before it, not the ones posted after the drain. Producers
+ * poll their ticket, e.g. to switch off the call lamp.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CALLQ_API
+#define CALLQ_API extern
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Maximum number of floors, one bit of the call bitmap each. */
+#define CALLQ_MAX_FLOORS 32U
+
+/** Shared state of the queue. Must only be accessed through the CallQ functions. */
+typedef struct {
+	uint32_t posted;                        /* Calls posted since the last drain, one bit per floor */
+	uint32_t generation[CALLQ_MAX_FLOORS];  /* Drains that took a call (times 2), bit 0: call posted */
+	uint32_t served[CALLQ_MAX_FLOORS];      /* Generation of the last service per floor */
+} CallQ;
+
+/** Initializes the queue to have no posted calls.
+  * Note: must not run concurrently with any other function on the same queue.
+  * @param[out] queue  Queue to initialize.
+  */
+CALLQ_API void CallQ_init(CallQ *queue);
+
+/** Posts a call. Safe to call from any number of threads concurrently.
+  * @param[in,out] queue   Queue to post the call into.
+  * @param[in]     floor   Floor of the call.
+  * @param[out]    ticket  Optional, receives the ticket to check the service of the call with.
+  * @return Returns false if the floor is out of range, true otherwise.
+  */
+CALLQ_API bool CallQ_post(CallQ *queue, const uint8_t floor, uint32_t *ticket);
+
+/** Checks whether the call of a ticket was served. Safe to call from any thread.
+  * @param[in] queue   Queue the call was posted into.
+  * @param[in] floor   Floor of the call.
+  * @param[in] ticket  Ticket returned by CallQ_post().
+  * @return Returns true if the floor was served after the call was taken over by the control loop.
+  */
+CALLQ_API bool CallQ_is_served(const CallQ *queue, const uint8_t floor, const uint32_t ticket);
+
+/** Takes all calls posted since the previous drain. Must only be called by the control loop.
+  * @param[in,out] queue  Queue to drain.
+  * @return Returns with the bitmap of the posted calls (bit n: floor n).
+  */
+CALLQ_API uint32_t CallQ_drain(CallQ *queue);
+
+/** Acknowledges the service of a floor to the producers: serves the calls of the floor taken over by
+  * the drains so far, not the ones posted since. Must only be called by the control loop.
+  * @param[in,out] queue  Queue of the call.
+  * @param[in]     floor  Served floor, ignored if out of range.
+  */
+CALLQ_API void CallQ_ack(CallQ *queue, const uint8_t floor);
+
+#ifdef __cplusplus
+}
+#endif
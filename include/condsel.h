@@ -12,9 +12,31 @@
  * |   3   | call above pending                  |
  * |   4   | door closed                         |
  * |   5   | door open                           |
- * |   6   | reserved                            |
+ * |   6   | packed condition vector (dispatch)  |
  * |   7   | fixed 0 (false)                     |
  * +-------+-------------------------------------+
+ *
+ * Index 6 selects the packed condition vector, which is used by the multi-way dispatch
+ * instructions of the sequential network. As a single boolean it always reads as false.
+ * +-----+-------------------------------------+
+ * | Bit | Packed condition vector             |
+ * +-----+-------------------------------------+
+ * |  0  | call below pending                  |
+ * |  1  | call same pending                   |
+ * |  2  | call above pending                  |
+ * |  3  | door closed                         |
+ * +-----+-------------------------------------+
+ *
+ * The packed sensor word holds all inputs of a cycle, including the results of the position
+ * checks. Its low bits are laid out like the packed condition vector.
+ * +-----+-------------------------------------+
+ * | Bit | Packed sensor word                  |
+ * +-----+-------------------------------------+
+ * | 3..0| as the packed condition vector      |
+ * |  4  | door open                           |
+ * |  5  | elevator position ok                |
+ * |  6  | door position ok                    |
+ * +-----+-------------------------------------+
  */
 
 #ifdef __cplusplus
@@ -27,6 +49,25 @@ extern "C" {
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "posdet.h"
+
+/* Condition selector index of the packed condition vector. */
+#define CONDSEL_INDEX_DISPATCH  6U
+
+/* Bits of the packed condition vector. */
+#define CONDSEL_VEC_BELOW       (1U << 0)
+#define CONDSEL_VEC_SAME        (1U << 1)
+#define CONDSEL_VEC_ABOVE       (1U << 2)
+#define CONDSEL_VEC_DOOR_CLOSED (1U << 3)
+
+/* Bits of the packed sensor word. */
+#define CONDSEL_IN_BELOW           CONDSEL_VEC_BELOW
+#define CONDSEL_IN_SAME            CONDSEL_VEC_SAME
+#define CONDSEL_IN_ABOVE           CONDSEL_VEC_ABOVE
+#define CONDSEL_IN_DOOR_CLOSED     CONDSEL_VEC_DOOR_CLOSED
+#define CONDSEL_IN_DOOR_OPEN       (1U << 4)
+#define CONDSEL_IN_ELEVATOR_POS_OK (1U << 5)
+#define CONDSEL_IN_DOOR_POS_OK     (1U << 6)
 
 /** Input values of the condition selector. */
 typedef struct {
@@ -45,6 +86,62 @@ typedef struct {
  */
 CONDSEL_API bool CondSel_calc(const bool invert, const uint8_t index, const CondSel_In values);
 
+/** Calculates the packed condition vector (@see documentation for the bit layout).
+ * @param[in] values  External input values to pack.
+ * @return Returns with the packed vector. Call bits are cleared if the elevator position is not ok,
+ *         the door bit is cleared if the door position is not ok.
+ */
+CONDSEL_API uint8_t CondSel_vector(const CondSel_In values);
+
+/** Calculates the condition value the sequential network expects for the given instruction.
+ * @param[in] invert  Return value is inverted (ignored for the packed condition vector).
+ * @param[in] index   Index of the value to select (@see documentation for details).
+ * @param[in] values  External input values to select.
+ * @return Returns with the packed condition vector if index selects it, otherwise with CondSel_calc().
+ */
+CONDSEL_API uint8_t CondSel_eval(const bool invert, const uint8_t index, const CondSel_In values);
+
+/** Same as CondSel_calc(), with the position checks of a PosDet instance instead of the global binding.
+ * @param[in] posdet  Position detector of the car (@see PosDet_Ops).
+ * @param[in] invert  Return value is inverted.
+ * @param[in] index   Index of the value to select (@see documentation for details).
+ * @param[in] values  External input values to select.
+ * @return Resturns with the selected value or the negated value of it.
+ */
+CONDSEL_API bool CondSel_calc_ops(const PosDet_Ops *posdet, const bool invert, const uint8_t index, const CondSel_In values);
+
+/** Same as CondSel_vector(), with the position checks of a PosDet instance.
+ * @param[in] posdet  Position detector of the car (@see PosDet_Ops).
+ * @param[in] values  External input values to pack.
+ * @return Returns with the packed vector.
+ */
+CONDSEL_API uint8_t CondSel_vector_ops(const PosDet_Ops *posdet, const CondSel_In values);
+
+/** Same as CondSel_eval(), with the position checks of a PosDet instance.
+ * @param[in] posdet  Position detector of the car (@see PosDet_Ops).
+ * @param[in] invert  Return value is inverted (ignored for the packed condition vector).
+ * @param[in] index   Index of the value to select (@see documentation for details).
+ * @param[in] values  External input values to select.
+ * @return Returns with the packed condition vector if index selects it, otherwise with CondSel_calc_ops().
+ */
+CONDSEL_API uint8_t CondSel_eval_ops(const PosDet_Ops *posdet, const bool invert, const uint8_t index, const CondSel_In values);
+
+/** Packs the inputs of a cycle into a sensor word (@see documentation for the bit layout).
+ * @param[in] values                External input values.
+ * @param[in] elevator_position_ok  Result of the elevator position check.
+ * @param[in] door_position_ok      Result of the door position check.
+ * @return Returns with the packed sensor word.
+ */
+CONDSEL_API uint8_t CondSel_pack(const CondSel_In values, const bool elevator_position_ok, const bool door_position_ok);
+
+/** Same as CondSel_eval(), with all inputs and position check results taken from a packed sensor word.
+ * @param[in] invert   Return value is inverted (ignored for the packed condition vector).
+ * @param[in] index    Index of the value to select (@see documentation for details).
+ * @param[in] sensors  Packed sensor word (@see CondSel_pack).
+ * @return Returns with the packed condition vector if index selects it, otherwise with the boolean result.
+ */
+CONDSEL_API uint8_t CondSel_eval_packed(const bool invert, const uint8_t index, const uint8_t sensors);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,44 @@
+#pragma once
+
+/** Controller module
+ * This component runs one controller as a single call per cycle: the condition of the previous
+ * instruction is evaluated on the new packed sensor word (@see CondSel_eval_packed in condsel.h),
+ * the sequential network is stepped with it (@see SeqNet_step_raw in seqnet.h), and the new
+ * instruction word is returned undecoded. The previous instruction is kept in the controller, so
+ * the caller holds no condition value between the cycles. The requests are read from the word with
+ * the accessor macros of seqnet.h, e.g. SEQNET_MOVE_UP() or SEQNET_REQUESTS() for all of them.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CONTROLLER_API
+#define CONTROLLER_API extern
+#endif
+
+#include <stdint.h>
+#include "seqnet.h"
+
+/** State of one controller. */
+typedef struct {
+	SeqNet_State state;   /* Program counter */
+	uint16_t instruction; /* Previous instruction word, SEQNET_POWER_UP_INSTRUCTION before the first step */
+} Controller;
+
+/** Returns a controller to its power-up state.
+  * @param[out] controller  Controller to initialize.
+  */
+CONTROLLER_API void Controller_init(Controller *controller);
+
+/** Steps the controller by one cycle.
+  * @param[in,out] controller  Controller to step.
+  * @param[in]     sensors     Packed sensor word, sensed after the previous instruction was actuated
+  *                            (@see CondSel_pack in condsel.h).
+  * @return Returns with the new 16-bit instruction word (@see seqnet.h).
+  */
+CONTROLLER_API uint16_t Controller_step(Controller *controller, const uint8_t sensors);
+
+#ifdef __cplusplus
+}
+#endif
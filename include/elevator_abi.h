@@ -0,0 +1,92 @@
+#pragma once
+
+/** Batch stepping C ABI
+ * This is the stable interface of the shared library (libelevator) for embedding the controller
+ * from other runtimes through an FFI. A batch is an opaque handle owning N independent controllers.
+ * One call steps all of them (optionally for several cycles) over caller-owned, contiguous arrays:
+ * - sensors[cycle * count + car]: packed sensor word of the car (@see CondSel_pack in condsel.h),
+ *   sensed after the outputs of the previous step were actuated
+ * - outputs[cycle * count + car]: instruction word requested by the car (@see seqnet.h), written
+ *   directly into the caller's array
+ * The condition of every step is calculated from the previous instruction of the car and its new
+ * sensor word, so the caller only moves sensor and instruction words across the boundary.
+ *
+ * Versioning: the major version changes with incompatible changes of this header, and is the
+ * SOVERSION of the shared library. The minor version grows with compatible additions.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#if defined(ELEVATOR_ABI_BUILD)
+#define ELEV_API __declspec(dllexport)
+#else
+#define ELEV_API __declspec(dllimport)
+#endif
+#elif defined(ELEVATOR_ABI_BUILD)
+#define ELEV_API __attribute__((visibility("default")))
+#else
+#define ELEV_API
+#endif
+
+#define ELEV_ABI_VERSION_MAJOR  1U
+#define ELEV_ABI_VERSION_MINOR  0U
+
+/* Return values. */
+#define ELEV_OK                 0
+#define ELEV_ERR_INVALID        (-1)  /* Invalid handle, array or count */
+
+/* Bits of the output instruction word (@see seqnet.h). */
+#define ELEV_OUT_JUMP_ADDR      0x00FFU
+#define ELEV_OUT_MOVE_UP        (1U << 8)
+#define ELEV_OUT_MOVE_DOWN      (1U << 9)
+#define ELEV_OUT_DOOR_OPEN      (1U << 10)
+#define ELEV_OUT_RESET_CALL     (1U << 11)
+
+/** Opaque handle of a batch of controllers. */
+typedef struct ElevBatch ElevBatch;
+
+/** Reads the version of the loaded library.
+  * @return Returns with (major << 16) | minor.
+  */
+ELEV_API uint32_t elev_abi_version(void);
+
+/** Allocates a batch of controllers, all in their power-up state.
+  * @param[in] count  Number of controllers (at least 1).
+  * @return Returns with the handle, or NULL if count is 0 or the allocation failed.
+  */
+ELEV_API ElevBatch *elev_batch_create(uint32_t count);
+
+/** Frees a batch. NULL is ignored.
+  * @param[in] batch  Handle of the batch.
+  */
+ELEV_API void elev_batch_destroy(ElevBatch *batch);
+
+/** Reads the number of controllers of a batch.
+  * @param[in] batch  Handle of the batch.
+  * @return Returns with the number of controllers, 0 for NULL.
+  */
+ELEV_API uint32_t elev_batch_count(const ElevBatch *batch);
+
+/** Returns all controllers of a batch to their power-up state.
+  * @param[in] batch  Handle of the batch.
+  * @return Returns with ELEV_OK or ELEV_ERR_INVALID.
+  */
+ELEV_API int elev_batch_reset(ElevBatch *batch);
+
+/** Steps every controller of the batch for the given number of cycles.
+  * @param[in]  batch    Handle of the batch.
+  * @param[in]  sensors  count * cycles packed sensor words, cycle-major.
+  * @param[out] outputs  count * cycles instruction words, cycle-major.
+  * @param[in]  cycles   Number of cycles to step.
+  * @return Returns with ELEV_OK or ELEV_ERR_INVALID.
+  */
+ELEV_API int elev_batch_step(ElevBatch *batch, const uint8_t *sensors, uint16_t *outputs, uint32_t cycles);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,92 @@
+#pragma once
+
+/** Program equivalence module
+ * This component decides whether two program images (@see seqnet.h) behave the same for every
+ * sequence of sensor words (@see CondSel_pack), i.e. for all CondSel_In and PosDet inputs. The
+ * observed behaviour is the request field of the instructions (move up/down, door, reset call).
+ *
+ * Both programs start from power-up (PC 0, condition 0). The product automaton of the two programs
+ * is explored breadth first from there, so a difference is reported with a shortest input trace.
+ *
+ * Two notions of equivalence are supported, selected by the stretch parameter:
+ * - 0 (lockstep): a new sensor word every cycle, the requests have to be equal in every cycle.
+ * - N > 0 (stretching): a sensor word is held until both programs reacted, so one program may
+ *   take more cycles than the other for the same decision. A reaction is the first change of the
+ *   requests within N cycles; both programs have to react with the same requests, or both not at
+ *   all. Races between a change of the inputs and a longer reaction are not considered.
+ *
+ * The frontier of each level is expanded by several threads, the visited product states are kept
+ * in a lock-free open addressing hash set of 32-bit keys with their parent links.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef EQUIV_API
+#define EQUIV_API extern
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Number of distinct packed sensor words, the input alphabet. */
+#define EQUIV_SENSOR_WORDS  128U
+
+/* Maximum number of worker threads. */
+#define EQUIV_MAX_THREADS   64U
+
+/** Position of a program, as seen by the checker. */
+typedef struct {
+	uint8_t pc;              /* Program counter */
+	bool power_up;           /* The power-up cycle is next, its condition is 0 */
+} Equiv_Machine;
+
+/** Parameters of a check. */
+typedef struct {
+	uint8_t stretch;         /* 0: lockstep, otherwise the reaction window in cycles */
+	uint8_t threads;         /* Number of worker threads, 0 selects 1 */
+} Equiv_Config;
+
+/** Result of a check. */
+typedef struct {
+	bool equivalent;         /* The programs are equivalent */
+	uint32_t states;         /* Number of reachable product states explored */
+	uint32_t length;         /* Number of inputs of the counterexample, 0 if equivalent */
+	uint8_t *trace;          /* Sensor words of the counterexample, free with Equiv_free() */
+} Equiv_Result;
+
+/** Initializes a machine to power-up.
+  * @param[out] machine  Machine to initialize.
+  */
+EQUIV_API void Equiv_init(Equiv_Machine *machine);
+
+/** Reacts to a sensor word, the way the checker steps a program.
+  * @param[in]     image    Program image of SEQNET_PROG_MEM_SIZE instruction words.
+  * @param[in,out] machine  Position of the program.
+  * @param[in]     sensors  Packed sensor word, held during the reaction.
+  * @param[in]     stretch  0: one cycle, otherwise the reaction window (@see Equiv_Config).
+  * @param[out]    output   Receives the requests (instruction bits 11..8) after the reaction.
+  * @return Returns with the number of cycles stepped until the requests changed, 0 if they did not
+  *         change within the window. In lockstep always 1.
+  */
+EQUIV_API uint8_t Equiv_react(const uint16_t *image, Equiv_Machine *machine, const uint8_t sensors,
+                              const uint8_t stretch, uint8_t *output);
+
+/** Checks the equivalence of two program images.
+  * @param[in]  a       First program image (e.g. SeqNet_program()).
+  * @param[in]  b       Second program image.
+  * @param[in]  config  Parameters of the check.
+  * @param[out] result  Receives the verdict and the counterexample.
+  * @return Returns with 0 on success, with a negative errno value otherwise.
+  */
+EQUIV_API int Equiv_check(const uint16_t *a, const uint16_t *b, const Equiv_Config *config, Equiv_Result *result);
+
+/** Frees the counterexample of a result.
+  * @param[in,out] result  Result of Equiv_check().
+  */
+EQUIV_API void Equiv_free(Equiv_Result *result);
+
+#ifdef __cplusplus
+}
+#endif
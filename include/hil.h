@@ -0,0 +1,162 @@
+#pragma once
+
+/** Hardware-in-the-loop gateway module
+ * This component connects the controller to a plant/IO emulator running in another process on
+ * the same host. Every tick the peer sends a frame with the packed sensor words of a batch of cars
+ * (@see CondSel_pack), and the gateway answers with the instruction words the controllers requested
+ * (@see SeqNet_encode), one controller per car.
+ *
+ * Tick synchronization: the peer is the clock master. It opens the session with HIL_FRAME_HELLO
+ * (number of cars, protocol version), the gateway acknowledges with HIL_FRAME_HELLO_ACK. Then the
+ * peer sends HIL_FRAME_SENSORS with tick 0, 1, 2, ... and waits for the HIL_FRAME_ACTUATORS of the
+ * same tick before it advances. A frame out of order ends the session with -EPROTO.
+ * HIL_FRAME_BYE ends the session regularly.
+ *
+ * Transports, selected by the address:
+ * - "unix:PATH" - Unix domain socket (SOCK_SEQPACKET), one frame per message.
+ * - "shm:NAME"  - POSIX shared memory object with one single-producer single-consumer ring per
+ *                 direction. The receiver spins briefly and then sleeps on a futex (Linux), so an
+ *                 idle rig does not occupy a CPU.
+ * The gateway side creates the endpoint (HIL_serve), the peer connects to it (HIL_connect). The
+ * endpoint is removed as soon as the peer connected, so a crashed rig leaves nothing behind.
+ *
+ * Both sides measure the round trip: the time from sending a frame until the answer of the
+ * peer arrives.
+ *
+ * Note: only available on POSIX systems, the functions fail with -ENOSYS elsewhere.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef HIL_API
+#define HIL_API extern
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include "histo.h"
+
+#define HIL_VERSION        1U
+
+/* Maximum number of cars of a frame. */
+#define HIL_MAX_CARS       256U
+
+/* Default timeout of connecting and receiving. */
+#define HIL_TIMEOUT_MS     5000
+
+/* Values of HIL_Frame.type. */
+#define HIL_FRAME_HELLO      1U  /* Peer: number of cars in count, HIL_VERSION in tick */
+#define HIL_FRAME_HELLO_ACK  2U  /* Gateway: session accepted */
+#define HIL_FRAME_SENSORS    3U  /* Peer: packed sensor words of the tick */
+#define HIL_FRAME_ACTUATORS  4U  /* Gateway: instruction words of the tick */
+#define HIL_FRAME_BYE        5U  /* Peer: end of the session */
+
+/** A frame, only the first count words of the payload are transferred. */
+typedef struct {
+	uint32_t type;                   /* HIL_FRAME_* */
+	uint32_t count;                  /* Number of payload words */
+	uint64_t tick;                   /* Tick of the frame */
+	uint16_t words[HIL_MAX_CARS];    /* Sensor words or instruction words, one per car */
+} HIL_Frame;
+
+/* Size of a frame without the payload. */
+#define HIL_FRAME_HEADER_SIZE  offsetof(HIL_Frame, words)
+
+/** Transport of a link. */
+typedef enum {
+	HIL_TRANSPORT_UNIX,
+	HIL_TRANSPORT_SHM
+} HIL_Transport;
+
+/** One end of a connection. */
+typedef struct {
+	HIL_Transport transport;         /* Transport of the address */
+	int fd;                          /* Unix: connected socket, -1 if none */
+	void *base;                      /* Shm: start of the mapping, NULL if not mapped */
+	size_t size;                     /* Shm: size of the mapping */
+	void *rx;                        /* Shm: ring of the received frames */
+	void *tx;                        /* Shm: ring of the sent frames */
+	int timeout_ms;                  /* Timeout of HIL_receive() */
+} HIL_Link;
+
+/** Round trip statistics of one side. */
+typedef struct {
+	Histo rtt;                       /* Round trip times in nanoseconds */
+	uint64_t ticks;                  /* Number of ticks exchanged */
+} HIL_Stats;
+
+/** Creates the endpoint of an address and waits until the peer connected.
+  * @param[out] link        Link to initialize.
+  * @param[in]  address     "unix:PATH" or "shm:NAME".
+  * @param[in]  timeout_ms  Timeout of waiting for the peer, and of HIL_receive() on the link.
+  * @return Returns with 0 on success, with a negative errno value otherwise (-ETIMEDOUT if no peer
+  *         connected within the timeout).
+  */
+HIL_API int HIL_serve(HIL_Link *link, const char *address, const int timeout_ms);
+
+/** Connects to the endpoint of an address, retrying until it exists or the timeout expires.
+  * @param[out] link        Link to initialize.
+  * @param[in]  address     "unix:PATH" or "shm:NAME".
+  * @param[in]  timeout_ms  Timeout of waiting for the endpoint, and of HIL_receive() on the link.
+  * @return Returns with 0 on success, with a negative errno value otherwise.
+  */
+HIL_API int HIL_connect(HIL_Link *link, const char *address, const int timeout_ms);
+
+/** Closes the link, a peer waiting for a frame of it fails with -EPIPE.
+  * @param[in,out] link  Link to close.
+  */
+HIL_API void HIL_close(HIL_Link *link);
+
+/** Sends a frame.
+  * @param[in,out] link   Link to send on.
+  * @param[in]     frame  Frame to send, count must not exceed HIL_MAX_CARS.
+  * @return Returns with 0 on success, with a negative errno value otherwise.
+  */
+HIL_API int HIL_send(HIL_Link *link, const HIL_Frame *frame);
+
+/** Receives a frame, waiting at most the timeout of the link.
+  * @param[in,out] link   Link to receive on.
+  * @param[out]    frame  Receives the frame.
+  * @return Returns with 0 on success, with a negative errno value otherwise (-ETIMEDOUT, -EPIPE if
+  *         the peer closed a socket, -EPROTO for a malformed frame).
+  */
+HIL_API int HIL_receive(HIL_Link *link, HIL_Frame *frame);
+
+/** Gateway side: serves a session, stepping one controller per car for every sensor frame.
+  * @param[in,out] link   Connected link (@see HIL_serve).
+  * @param[out]    stats  Receives the round trips from the actuator frames to the next sensor frame.
+  * @return Returns with 0 when the peer ended the session, with a negative errno value otherwise.
+  */
+HIL_API int HIL_run_gateway(HIL_Link *link, HIL_Stats *stats);
+
+/** Peer side: opens a session.
+  * @param[in,out] link   Connected link (@see HIL_connect).
+  * @param[in]     cars   Number of cars, at most HIL_MAX_CARS.
+  * @param[out]    stats  Statistics of the session to initialize.
+  * @return Returns with 0 on success, with a negative errno value otherwise.
+  */
+HIL_API int HIL_hello(HIL_Link *link, const uint32_t cars, HIL_Stats *stats);
+
+/** Peer side: sends the sensor words of a tick and waits for the instruction words of the tick.
+  * @param[in,out] link     Link of the session.
+  * @param[in]     tick     Tick, starting with 0 and incremented by one.
+  * @param[in]     sensors  Packed sensor words, one per car.
+  * @param[out]    outputs  Receives the instruction words, one per car.
+  * @param[in]     cars     Number of cars of the session.
+  * @param[in,out] stats    Statistics of the session.
+  * @return Returns with 0 on success, with a negative errno value otherwise.
+  */
+HIL_API int HIL_exchange(HIL_Link *link, const uint64_t tick, const uint8_t *sensors, uint16_t *outputs,
+                         const uint32_t cars, HIL_Stats *stats);
+
+/** Peer side: ends the session.
+  * @param[in,out] link  Link of the session.
+  * @return Returns with 0 on success, with a negative errno value otherwise.
+  */
+HIL_API int HIL_bye(HIL_Link *link);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,92 @@
+#pragma once
+
+/** Log-linear histogram module
+ * This component counts non-negative integer samples (e.g. nanoseconds or cycles) in buckets
+ * whose width grows with the magnitude of the value: every power of two range is split into
+ * HISTO_SUB_BUCKETS linear sub-buckets. Values below HISTO_SUB_BUCKETS are counted exactly,
+ * above that the relative bucket width is at most 1 / HISTO_SUB_BUCKETS.
+ * Recording is a few integer operations and never allocates, so it is usable inside the
+ * control loop. Histograms with the same bucket layout merge exactly by adding the counts, so
+ * histograms of separate runs, threads or processes can be combined after the fact.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef HISTO_API
+#define HISTO_API extern
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+/* Number of linear sub-buckets per power of two range (log2). */
+#define HISTO_SUB_BITS      4U
+#define HISTO_SUB_BUCKETS   (1U << HISTO_SUB_BITS)
+
+/* Number of buckets needed to cover the full uint64_t range. */
+#define HISTO_BUCKETS       ((64U - HISTO_SUB_BITS + 1U) * HISTO_SUB_BUCKETS)
+
+typedef struct {
+	uint64_t counts[HISTO_BUCKETS];  /* Number of samples per bucket */
+	uint64_t total;                  /* Number of samples */
+	uint64_t sum;                    /* Sum of the samples (wraps on overflow) */
+	uint64_t min;                    /* Smallest sample, UINT64_MAX if empty */
+	uint64_t max;                    /* Largest sample, 0 if empty */
+} Histo;
+
+/** Clears the histogram.
+  * @param[out] histo  Histogram to clear.
+  */
+HISTO_API void Histo_init(Histo *histo);
+
+/** Counts a sample.
+  * @param[in,out] histo  Histogram to update.
+  * @param[in]     value  Sample value.
+  */
+HISTO_API void Histo_record(Histo *histo, const uint64_t value);
+
+/** Calculates the bucket index of a value.
+  * @param[in] value  Sample value.
+  * @return Returns with the index of the bucket counting the value.
+  */
+HISTO_API uint32_t Histo_bucket(const uint64_t value);
+
+/** Calculates the smallest value of a bucket.
+  * @param[in] bucket  Bucket index (less than HISTO_BUCKETS).
+  * @return Returns with the lower bound of the bucket.
+  */
+HISTO_API uint64_t Histo_bucket_low(const uint32_t bucket);
+
+/** Calculates the largest value of a bucket.
+  * @param[in] bucket  Bucket index (less than HISTO_BUCKETS).
+  * @return Returns with the upper bound (inclusive) of the bucket.
+  */
+HISTO_API uint64_t Histo_bucket_high(const uint32_t bucket);
+
+/** Calculates a percentile.
+  * @param[in] histo       Histogram to evaluate.
+  * @param[in] percentile  Percentile in the range of 0..100.
+  * @return Returns with the upper bound of the bucket containing the percentile, clamped to
+  *         the largest sample. Returns with 0 if the histogram is empty.
+  */
+HISTO_API uint64_t Histo_percentile(const Histo *histo, const double percentile);
+
+/** Adds the samples of a histogram to another one.
+  * @param[in,out] histo  Histogram to add to.
+  * @param[in]     other  Histogram to add.
+  */
+HISTO_API void Histo_merge(Histo *histo, const Histo *other);
+
+/** Writes a histogram as a JSON object: the number of samples, min, p50, p99, p99.9, max and
+  * the non-empty buckets as [low, high, count] triples, so readers can merge exported histograms.
+  * @param[in] histo  Histogram to write.
+  * @param[in] file   Stream to write to.
+  */
+HISTO_API void Histo_write_json(const Histo *histo, FILE *file);
+
+#ifdef __cplusplus
+}
+#endif
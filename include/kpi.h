@@ -0,0 +1,107 @@
+#pragma once
+
+/** Service KPI module
+ * This component measures how well a controller program serves the calls of one car, in control
+ * cycles. The simulator reports every new call and, after every cycle, the state of the car:
+ * - service: from the registration of a call until the controller requests the reset of the call
+ *   on its floor with the door open
+ * - dwell: from opening the door until it is closed again
+ * - travel: from the first movement after the door closed until the door opens again
+ * The samples are counted in log-linear histograms (@see histo.h) per floor (the floor of the
+ * call, of the open door, and the floor the trip ended at) and over all floors. The KPIs of
+ * separate scenarios merge, and are exported as JSON to compare controller programs.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef KPI_API
+#define KPI_API extern
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "histo.h"
+
+/* Maximum number of floors. */
+#define KPI_MAX_FLOORS  8U
+
+/* Registration cycle of a floor without a call. */
+#define KPI_NO_CALL     UINT64_MAX
+
+/** Histograms of one floor, or of all floors. */
+typedef struct {
+	Histo service;                   /* Cycles from call registration to reset with door open */
+	Histo dwell;                     /* Cycles the door was open */
+	Histo travel;                    /* Cycles of a trip between two door openings */
+} Kpi_Histos;
+
+/** KPIs of one car. */
+typedef struct {
+	uint8_t floors;                  /* Number of floors */
+	uint64_t cycle;                  /* Cycles reported */
+	uint64_t call_cycle[KPI_MAX_FLOORS]; /* Registration of the pending call, KPI_NO_CALL if none */
+	uint64_t dropped[KPI_MAX_FLOORS]; /* Calls still pending at a restart or merged from other KPIs */
+	bool known;                      /* The state of the car was reported before */
+	bool door_open;                  /* Door open after the previous cycle */
+	uint64_t door_since;             /* Cycle the door opened, 0 if unknown */
+	uint64_t trip_since;             /* Cycle the trip started, 0 if none */
+	Kpi_Histos floor[KPI_MAX_FLOORS]; /* Histograms per floor */
+	Kpi_Histos all;                  /* Histograms over all floors */
+} Kpi;
+
+/** Initializes the KPIs, without calls and samples.
+  * @param[out] kpi     KPIs to initialize.
+  * @param[in]  floors  Number of floors (1..KPI_MAX_FLOORS).
+  */
+KPI_API void Kpi_init(Kpi *kpi, const uint8_t floors);
+
+/** Forgets the state of the car, e.g. at the start of a new scenario. The pending calls are counted
+  * as unserved, the samples are kept.
+  * @param[in,out] kpi  KPIs to update.
+  */
+KPI_API void Kpi_restart(Kpi *kpi);
+
+/** Registers a call in the current cycle. A call of a floor with a pending call is ignored.
+  * @param[in,out] kpi    KPIs to update.
+  * @param[in]     floor  Floor of the call.
+  */
+KPI_API void Kpi_call(Kpi *kpi, const uint8_t floor);
+
+/** Reports the state of the car after a cycle.
+  * @param[in,out] kpi        KPIs to update.
+  * @param[in]     floor      Floor of the car.
+  * @param[in]     door_open  The door is open.
+  * @param[in]     moving     The car is moving.
+  * @param[in]     reset      The controller requested the reset of the call of the floor.
+  */
+KPI_API void Kpi_cycle(Kpi *kpi, const uint8_t floor, const bool door_open, const bool moving, const bool reset);
+
+/** Counts the calls of a floor that were not served, including the pending one.
+  * @param[in] kpi    KPIs to evaluate.
+  * @param[in] floor  Floor.
+  * @return Returns with the number of unserved calls.
+  */
+KPI_API uint64_t Kpi_unserved(const Kpi *kpi, const uint8_t floor);
+
+/** Adds the samples and the unserved calls of other KPIs.
+  * @param[in,out] kpi    KPIs to add to, with at least the floors of other.
+  * @param[in]     other  KPIs to add.
+  * @return Returns with 0 on success, -EINVAL if other has more floors.
+  */
+KPI_API int Kpi_merge(Kpi *kpi, const Kpi *other);
+
+/** Writes the KPIs of scenarios and their merged total as a JSON document.
+  * @param[in] file   Stream to write to.
+  * @param[in] kpis   KPIs of the scenarios, all with the same number of floors.
+  * @param[in] names  Names of the scenarios.
+  * @param[in] count  Number of scenarios.
+  * @return Returns with 0 on success, with a negative errno value otherwise.
+  */
+KPI_API int Kpi_write_json(FILE *file, const Kpi *kpis, const char *const *names, const uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,68 @@
+#pragma once
+
+/** Lockstep module
+ * This component runs a controller redundantly in two channels with independent state and
+ * cross-checks them every cycle. Each channel is a controller of its own (@see controller.h).
+ * Channel B is stored complemented, so a fault hitting both channels alike (e.g. a cleared or stuck
+ * word) shows up as a disagreement.
+ * +---------------+------------------------------------------------------------------+
+ * | Channel       | Stored state                                                     |
+ * +---------------+------------------------------------------------------------------+
+ * | channel (A)   | program counter and previous instruction word, plain             |
+ * | shadow (B)    | program counter and previous instruction word, complemented      |
+ * +---------------+------------------------------------------------------------------+
+ *
+ * The condition value is not stored: each channel evaluates it from its own previous instruction
+ * word on the new sensor word. A fault on the condition path of one channel is a flipped condition
+ * select or inversion bit of its stored word, which the comparison of the stored state catches
+ * before the condition is used.
+ *
+ * Both channels are stepped one after the other, they are not evaluated in parallel lanes. Packing
+ * both channels into the lanes of one word measured slower than two plain steps, and an interleaved
+ * step did not come in below them either: the lockstep does the work of two channels plus the
+ * checks. bench_controller reports its overhead next to two compared plain channels.
+ *
+ * Per cycle the stored state of both channels is compared field by field, both channels are
+ * stepped, and their new instruction words are compared. On the first disagreement the controller
+ * latches a safe stop: it returns LOCKSTEP_SAFE_STOP (no move requests, door closed) until it is
+ * initialized again.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef LOCKSTEP_API
+#define LOCKSTEP_API extern
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "seqnet.h"
+#include "controller.h"
+
+/* Instruction word of the safe stop: no requests, the condition is always false. */
+#define LOCKSTEP_SAFE_STOP  ((uint16_t)SEQNET_FIELD_COND_SEL)
+
+/** State of a redundant controller. */
+typedef struct {
+	Controller channel;   /* Channel A */
+	Controller shadow;    /* Channel B, program counter and instruction word complemented */
+	bool safe_stop;       /* The channels disagreed, the safe stop is latched */
+} Lockstep;
+
+/** Returns both channels to their power-up state and releases the safe stop.
+  * @param[out] lockstep  Redundant controller to initialize.
+  */
+LOCKSTEP_API void Lockstep_init(Lockstep *lockstep);
+
+/** Steps both channels by one cycle and compares them (@see Controller_step in controller.h).
+  * @param[in,out] lockstep  Redundant controller to step.
+  * @param[in]     sensors   Packed sensor word, sensed after the previous instruction was actuated.
+  * @return Returns with the new 16-bit instruction word, LOCKSTEP_SAFE_STOP if the safe stop is latched.
+  */
+LOCKSTEP_API uint16_t Lockstep_step(Lockstep *lockstep, const uint8_t sensors);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,142 @@
+#pragma once
+
+/** Continuous-motion plant model module
+ * This component simulates the mechanics of many cars: continuous car position and velocity with
+ * speed and acceleration limits, and a continuous door position. It derives the signals the
+ * controller senses from them: the level detector and the door end-switches (the PosDet inputs),
+ * and the call bits relative to the nearest floor.
+ *
+ * The drive works floor by floor, like the discrete simulator: a move request of a level, stopped
+ * car with closed door makes the adjacent floor the target, and the drive runs a trapezoidal speed
+ * profile to stop level there. Requests are ignored while the car travels. The door only moves
+ * while the car stands level, and the car only moves while the door is fully closed.
+ *
+ * The state of the cars is stored as struct of arrays and integrated without branches, so the
+ * compiler can vectorize Plant_step() across the cars.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef PLANT_API
+#define PLANT_API extern
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "posdet.h"
+
+/** Mechanical parameters, shared by all cars of a plant. */
+typedef struct {
+	uint8_t floors;          /* Number of floors (2..32) */
+	float floor_height;      /* Distance of the floors [m] */
+	float max_speed;         /* Speed limit of the car [m/s] */
+	float max_accel;         /* Acceleration limit of the car [m/s^2] */
+	float door_time;         /* Time to fully open or close the door [s] */
+	float level_tolerance;   /* Half width of the level detector window [m] */
+} Plant_Config;
+
+/** State of the cars, one array element per car. */
+typedef struct {
+	uint32_t count;          /* Number of cars */
+	Plant_Config config;     /* Mechanical parameters */
+	float *position;         /* Car position above floor 0 [m] */
+	float *velocity;         /* Car velocity, positive upwards [m/s] */
+	float *target;           /* Position the drive runs to [m] */
+	float *door;             /* Door position, 0: closed, 1: fully open */
+	float *door_request;     /* Requested door position, 0 or 1 */
+} Plant;
+
+/** A car of a plant, the context of its PosDet function table. */
+typedef struct {
+	const Plant *plant;      /* Plant of the car */
+	uint32_t index;          /* Index of the car */
+} Plant_Car;
+
+/** Fills a configuration with the parameters of a typical low-rise passenger elevator.
+  * @param[out] config  Configuration to fill.
+  * @param[in]  floors  Number of floors.
+  */
+PLANT_API void Plant_default_config(Plant_Config *config, const uint8_t floors);
+
+/** Allocates the cars, all standing level on floor 0 with open door.
+  * @param[out] plant   Plant to create.
+  * @param[in]  count   Number of cars.
+  * @param[in]  config  Mechanical parameters.
+  * @return Returns with 0 on success, with a negative errno value otherwise.
+  */
+PLANT_API int Plant_create(Plant *plant, const uint32_t count, const Plant_Config *config);
+
+/** Frees the cars.
+  * @param[in,out] plant  Plant to free.
+  */
+PLANT_API void Plant_destroy(Plant *plant);
+
+/** Places a car level on a floor with open or closed door, at rest.
+  * @param[in,out] plant      Plant of the car.
+  * @param[in]     car        Index of the car.
+  * @param[in]     floor      Floor to place the car on.
+  * @param[in]     door_open  Door fully open if true, closed otherwise.
+  */
+PLANT_API void Plant_place(Plant *plant, const uint32_t car, const uint8_t floor, const bool door_open);
+
+/** Applies the requests of an instruction word (@see seqnet.h) to a car.
+  * @param[in,out] plant        Plant of the car.
+  * @param[in]     car          Index of the car.
+  * @param[in]     instruction  Instruction word of the controller of the car.
+  */
+PLANT_API void Plant_command(Plant *plant, const uint32_t car, const uint16_t instruction);
+
+/** Integrates all cars over a time step.
+  * @param[in,out] plant  Plant to integrate.
+  * @param[in]     dt     Time step [s], should be well below floor_height / max_speed.
+  */
+PLANT_API void Plant_step(Plant *plant, const float dt);
+
+/** Calculates the floor nearest to a car.
+  * @param[in] plant  Plant of the car.
+  * @param[in] car    Index of the car.
+  * @return Returns with the nearest floor.
+  */
+PLANT_API uint8_t Plant_floor(const Plant *plant, const uint32_t car);
+
+/** Level detector: the car is within the level tolerance of a floor.
+  * @param[in] plant  Plant of the car.
+  * @param[in] car    Index of the car.
+  * @return Returns true if the car is level with a floor.
+  */
+PLANT_API bool Plant_is_level(const Plant *plant, const uint32_t car);
+
+/** Door closed end-switch.
+  * @param[in] plant  Plant of the car.
+  * @param[in] car    Index of the car.
+  * @return Returns true if the door is fully closed.
+  */
+PLANT_API bool Plant_is_door_closed(const Plant *plant, const uint32_t car);
+
+/** Door open end-switch.
+  * @param[in] plant  Plant of the car.
+  * @param[in] car    Index of the car.
+  * @return Returns true if the door is fully open.
+  */
+PLANT_API bool Plant_is_door_open(const Plant *plant, const uint32_t car);
+
+/** Senses all inputs of a car into a packed sensor word (@see CondSel_pack). The elevator position
+  * is ok if the level detector is active, the door position if one of the end-switches is active.
+  * @param[in] plant          Plant of the car.
+  * @param[in] car            Index of the car.
+  * @param[in] pending_calls  Pending calls of the car, bit n: floor n.
+  * @return Returns with the packed sensor word.
+  */
+PLANT_API uint8_t Plant_sense(const Plant *plant, const uint32_t car, const uint32_t pending_calls);
+
+/** Initializes a PosDet function table backed by the sensors of a car.
+  * @param[out] posdet   Function table to initialize, its context is the car.
+  * @param[in]  context  Car providing the signals, must outlive the function table.
+  */
+PLANT_API void Plant_init_posdet(PosDet_Ops *posdet, const Plant_Car *context);
+
+#ifdef __cplusplus
+}
+#endif
@@ -6,6 +6,53 @@
 extern "C" {
 #endif
 
+/**
+ * PosDet binding
+ *
+ * The global position checks below are bound in one of two ways, selected at compile time:
+ * - POSDET_BINDING_INLINE defined: the production stubs are defined inline in this header,
+ *   so the checks fold away in the callers (e.g. CondSel_calc).
+ * - otherwise: the checks are resolved at link time, against src/posdet.c or a test mock.
+ *
+ * Independently of the binding, PosDet_Ops is a per-instance function table, so different cars
+ * of a simulation can have different sensors (@see CondSel_calc_ops).
+ */
+
+/** Per-instance position detector. */
+typedef struct {
+	bool (*is_elevator_position_ok)(void *context);  /* @see PosDet_is_elevator_position_ok */
+	bool (*is_door_position_ok)(void *context);      /* @see PosDet_is_door_position_ok */
+	void *context;                                   /* Passed to the functions */
+} PosDet_Ops;
+
+#if defined(POSDET_BINDING_INLINE)
+
+/**
+ * @brief Checks if the elevator's current position is valid for stopping.
+ *
+ * Inline production stub, always returns true.
+ *
+ * @return True if the position is okay, false otherwise.
+ */
+static inline bool PosDet_is_elevator_position_ok(void)
+{
+    return true;
+}
+
+/**
+ * @brief Checks if the door's current position is valid.
+ *
+ * Inline production stub, always returns true.
+ *
+ * @return True if the position is okay, false otherwise.
+ */
+static inline bool PosDet_is_door_position_ok(void)
+{
+    return true;
+}
+
+#else
+
 /**
  * @brief Checks if the elevator's current position is valid for stopping.
  *
@@ -26,6 +73,8 @@ bool PosDet_is_elevator_position_ok(void);
  */
 bool PosDet_is_door_position_ok(void);
 
+#endif
+
 #ifdef __cplusplus
 }
 #endif
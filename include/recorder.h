@@ -0,0 +1,86 @@
+#pragma once
+
+/** Input recorder module
+ * This component logs what the controller saw in every cycle (the packed sensor word, @see
+ * CondSel_pack) together with what it requested (the instruction word, @see Controller_step)
+ * into a compact streaming file, and replays such a file against the controller.
+ *
+ * Inputs change rarely compared to the cycle rate, so the file is run-length encoded: a run is
+ * a sequence of cycles with the same sensor word, stored as
+ *   varint(cycle count) | sensor word (1 byte) | FNV-1a digest of the run's instruction words (4 bytes, LE)
+ * A run with a cycle count of 0 marks a controller reset (Controller_init) and has no further bytes.
+ * The file starts with the 4 bytes "ELRR" and a version byte.
+ *
+ * The replay runs Controller_step on the recorded sensor words as fast
+ * as possible and compares the digest of every run with the recorded one.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef RECORDER_API
+#define RECORDER_API extern
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#define RECORDER_VERSION  1U
+
+/** State of a recording. */
+typedef struct {
+	FILE *file;            /* Output file, NULL if not recording */
+	uint64_t run_cycles;   /* Number of cycles of the current run */
+	uint8_t run_sensors;   /* Sensor word of the current run */
+	uint32_t run_digest;   /* Digest of the instruction words of the current run */
+	uint64_t cycles;       /* Number of recorded cycles */
+	uint64_t runs;         /* Number of written runs */
+} Recorder;
+
+/** Result of a replay. */
+typedef struct {
+	uint64_t cycles;          /* Number of replayed cycles */
+	uint64_t runs;            /* Number of replayed runs */
+	uint64_t resets;          /* Number of controller resets */
+	uint64_t mismatches;      /* Number of runs whose outputs differ from the recording */
+	uint64_t first_mismatch;  /* First cycle of the first mismatching run (if any) */
+} Recorder_Result;
+
+/** Creates the recording file and writes its header.
+  * @param[out] recorder  State of the recording.
+  * @param[in]  path      Path of the file.
+  * @return Returns with 0 on success, with a negative errno value otherwise.
+  */
+RECORDER_API int Recorder_open(Recorder *recorder, const char *path);
+
+/** Records a controller reset. Call it together with Controller_init().
+  * @param[in,out] recorder  State of the recording.
+  */
+RECORDER_API void Recorder_reset(Recorder *recorder);
+
+/** Records a cycle.
+  * @param[in,out] recorder     State of the recording.
+  * @param[in]     sensors      Packed sensor word the condition of the cycle was calculated from.
+  * @param[in]     instruction  Instruction word returned by Controller_step() in the cycle.
+  */
+RECORDER_API void Recorder_cycle(Recorder *recorder, const uint8_t sensors, const uint16_t instruction);
+
+/** Writes the last run and closes the file.
+  * @param[in,out] recorder  State of the recording.
+  * @return Returns with 0 on success, with a negative errno value if any write failed.
+  */
+RECORDER_API int Recorder_close(Recorder *recorder);
+
+/** Replays a recording against the controller (which is reset at the start).
+  * @param[in]  path    Path of the recording.
+  * @param[out] result  Statistics of the replay.
+  * @return Returns with 0 if the file was replayed completely, with a negative errno value otherwise
+  *         (-EILSEQ for a malformed file). Output mismatches are reported in the result.
+  */
+RECORDER_API int Recorder_replay(const char *path, Recorder_Result *result);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,61 @@
+#pragma once
+
+/** Fixed-rate control loop runner module
+ * This component executes a cycle function at a fixed period on an absolute timeline
+ * (CLOCK_MONOTONIC, clock_nanosleep), optionally with SCHED_FIFO priority, CPU pinning and
+ * locked memory. It measures how late every cycle was released (period jitter), how long the
+ * cycle function ran and by how much a cycle overran into the next period.
+ * If a cycle overruns, the missed releases are skipped and the loop continues on the original
+ * timeline.
+ * The scheduling policy, CPU affinity and memory locking of the calling thread are restored when
+ * the runner returns.
+ * Note: only available on Linux, RtLoop_run() fails with -ENOSYS elsewhere.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef RTLOOP_API
+#define RTLOOP_API extern
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "histo.h"
+
+/** Configuration of the runner. */
+typedef struct {
+	uint64_t period_ns;    /* Period of the cycles */
+	uint64_t cycles;       /* Number of cycles to run, 0 to run until the cycle function stops */
+	int fifo_priority;     /* SCHED_FIFO priority, 0 keeps the scheduling policy of the caller */
+	int cpu;               /* CPU to pin the calling thread to, negative for no pinning */
+	bool lock_memory;      /* Lock all current and future memory and pre-fault the stack */
+} RtLoop_Config;
+
+/** Statistics of a run. All times are in nanoseconds. */
+typedef struct {
+	Histo jitter;          /* Wake-up time minus scheduled release time, per cycle */
+	Histo exec;            /* Execution time of the cycle function, per cycle */
+	Histo overrun;         /* End of the cycle minus the next release time, per overrun */
+	uint64_t cycles;       /* Number of executed cycles */
+	uint64_t overruns;     /* Number of cycles which ended after the next release */
+	uint64_t missed;       /* Number of skipped releases */
+} RtLoop_Stats;
+
+/** Cycle function, returns false to stop the runner. */
+typedef bool (*RtLoop_CycleFn)(void *context);
+
+/** Runs the cycle function at a fixed period on the calling thread.
+  * @param[in]  config   Configuration of the runner.
+  * @param[in]  cycle    Cycle function.
+  * @param[in]  context  Passed to the cycle function.
+  * @param[out] stats    Statistics of the run, cleared at the start.
+  * @return Returns with 0 on success, with a negative errno value if the configuration could not
+  *         be applied (e.g. -EPERM for SCHED_FIFO without privileges).
+  */
+RTLOOP_API int RtLoop_run(const RtLoop_Config *config, RtLoop_CycleFn cycle, void *context, RtLoop_Stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,259 @@
+#pragma once
+
+/** Scenario scripting module (C++20)
+ * Scenarios are coroutines that drive simulated cars: they post calls and co_await conditions of
+ * their car ("standing on floor 3", "door open", "call served", "N cycles"). A single-threaded
+ * Scheduler steps all cars in lockstep (controller batch and continuous plant model) and resumes a
+ * scenario only when the condition it waits for fires, so suites of tens of thousands of scenarios
+ * run without a thread per scenario.
+ *
+ * Example:
+ *   Scenario ride(Car car) {
+ *       car.call(3U);
+ *       co_await car.wait_floor(3U);
+ *       co_await car.wait_door_open();
+ *       co_await car.wait_cycles(100U);
+ *   }
+ *
+ *   Scheduler scheduler(cars, config);
+ *   scheduler.spawn(ride(scheduler.car(0U)));
+ *   scheduler.run(max_cycles);
+ *
+ * A scenario can co_await another scenario to use it as a subroutine.
+ */
+
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <queue>
+#include <utility>
+#include <vector>
+
+extern "C" {
+#include "elevator_abi.h"
+#include "plant.h"
+}
+
+namespace elevator {
+
+class Scheduler;
+
+/** Coroutine type of the scenarios. */
+class Scenario {
+public:
+    struct promise_type {
+        std::coroutine_handle<> continuation;   /* Awaiting scenario, resumed on completion */
+        Scheduler *scheduler = nullptr;         /* Set for the scenarios spawned on a scheduler */
+        uint32_t root = 0U;                     /* Slot of a spawned scenario in the scheduler */
+        std::exception_ptr exception;           /* Unhandled exception of the scenario */
+
+        Scenario get_return_object() {
+            return Scenario(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        auto final_suspend() noexcept;
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { exception = std::current_exception(); }
+    };
+
+    Scenario(Scenario &&other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    Scenario(const Scenario &) = delete;
+    Scenario &operator=(const Scenario &) = delete;
+    Scenario &operator=(Scenario &&) = delete;
+    ~Scenario() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    /** Runs the scenario as a subroutine of the awaiting one. */
+    auto operator co_await() && noexcept;
+
+private:
+    friend class Scheduler;
+
+    explicit Scenario(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+/** Conditions a scenario can wait for. */
+enum class Wait : uint8_t {
+    Floor,       /* The car stands level on the floor of the argument */
+    DoorOpen,    /* The door is fully open */
+    DoorClosed,  /* The door is fully closed */
+    Served,      /* No call is pending on the floor of the argument */
+    Idle,        /* No call is pending and the door is fully open */
+};
+
+/** Awaitable condition of a car. */
+struct Condition {
+    Scheduler *scheduler;
+    uint32_t car;
+    Wait wait;
+    uint8_t floor;
+
+    bool await_ready() const noexcept;
+    void await_suspend(std::coroutine_handle<> handle) const;
+    void await_resume() const noexcept {}
+};
+
+/** Awaitable number of cycles. */
+struct Cycles {
+    Scheduler *scheduler;
+    uint64_t count;
+
+    bool await_ready() const noexcept { return count == 0U; }
+    void await_suspend(std::coroutine_handle<> handle) const;
+    void await_resume() const noexcept {}
+};
+
+/** Handle of a simulated car, passed to the scenarios by value. */
+class Car {
+public:
+    Car(Scheduler *scheduler, uint32_t index) : scheduler_(scheduler), index_(index) {}
+
+    uint32_t index() const { return index_; }
+    uint64_t cycle() const;
+    uint8_t floor() const;
+    bool level() const;
+    bool door_open() const;
+    bool door_closed() const;
+    uint32_t pending_calls() const;
+
+    /** Posts a call to a floor of the car. */
+    void call(uint8_t floor) const;
+
+    Condition wait_floor(uint8_t floor) const { return {scheduler_, index_, Wait::Floor, floor}; }
+    Condition wait_door_open() const { return {scheduler_, index_, Wait::DoorOpen, 0U}; }
+    Condition wait_door_closed() const { return {scheduler_, index_, Wait::DoorClosed, 0U}; }
+    Condition wait_served(uint8_t floor) const { return {scheduler_, index_, Wait::Served, floor}; }
+    Condition wait_idle() const { return {scheduler_, index_, Wait::Idle, 0U}; }
+    Cycles wait_cycles(uint64_t count) const { return {scheduler_, count}; }
+
+private:
+    Scheduler *scheduler_;
+    uint32_t index_;
+};
+
+/** Steps the cars and resumes the scenarios whose conditions fired. Single-threaded. */
+class Scheduler {
+public:
+    /** Creates the cars, all standing on floor 0 with open door. Throws std::runtime_error on failure.
+      * @param[in] cars    Number of cars.
+      * @param[in] config  Mechanical parameters of the cars.
+      * @param[in] dt      Control cycle and plant time step [s].
+      */
+    Scheduler(uint32_t cars, const Plant_Config &config, float dt = 0.01f);
+    ~Scheduler();
+
+    Scheduler(const Scheduler &) = delete;
+    Scheduler &operator=(const Scheduler &) = delete;
+
+    Car car(uint32_t index) { return Car(this, index); }
+    uint32_t cars() const { return plant_.count; }
+    uint64_t cycle() const { return cycle_; }
+    const Plant &plant() const { return plant_; }
+
+    /** Takes over a scenario, it starts on the next run(). */
+    void spawn(Scenario scenario);
+
+    /** Number of spawned scenarios that have not finished yet. */
+    uint32_t live() const { return live_; }
+
+    /** Runs until all scenarios finished or for at most the given number of cycles. Rethrows the
+      * first unhandled exception of a scenario.
+      * @param[in] max_cycles  Cycle budget of this call.
+      * @return Returns with the number of cycles stepped.
+      */
+    uint64_t run(uint64_t max_cycles);
+
+private:
+    friend struct Condition;
+    friend struct Cycles;
+    friend class Car;
+    friend struct Scenario::promise_type;
+    friend class Scenario;
+
+    struct Waiter {
+        std::coroutine_handle<> handle;
+        Wait wait;
+        uint8_t floor;
+    };
+
+    struct Timer {
+        uint64_t cycle;
+        uint64_t order;   /* Keeps timers of the same cycle in FIFO order */
+        std::coroutine_handle<> handle;
+
+        bool operator>(const Timer &other) const {
+            return (cycle != other.cycle) ? (cycle > other.cycle) : (order > other.order);
+        }
+    };
+
+    bool check(uint32_t car, Wait wait, uint8_t floor) const;
+    uint64_t snapshot(uint32_t car) const;
+    void step();
+    void wake();
+    void resume_ready();
+    void finish(uint32_t root, std::exception_ptr exception);
+
+    Plant plant_ {};
+    ElevBatch *batch_ = nullptr;
+    float dt_;
+    uint64_t cycle_ = 0U;
+
+    std::vector<uint32_t> calls_;                  /* Pending calls per car, bit n: floor n */
+    std::vector<uint8_t> sensors_;
+    std::vector<uint16_t> outputs_;
+
+    std::vector<std::vector<Waiter>> waiters_;     /* Condition waits per car */
+    std::vector<uint64_t> snapshots_;              /* Sensed state per car at the last check */
+    std::vector<uint32_t> watched_;                /* Cars with condition waits */
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers_;
+    uint64_t timer_order_ = 0U;
+
+    std::vector<std::coroutine_handle<>> ready_;
+    std::vector<std::coroutine_handle<Scenario::promise_type>> roots_;
+    std::vector<uint32_t> free_roots_;
+    uint32_t live_ = 0U;
+    std::exception_ptr exception_;
+};
+
+inline auto Scenario::promise_type::final_suspend() noexcept {
+    struct Final {
+        bool await_ready() const noexcept { return false; }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+            promise_type &promise = handle.promise();
+            if (promise.continuation) {
+                return promise.continuation;
+            }
+            if (promise.scheduler != nullptr) {
+                promise.scheduler->finish(promise.root, promise.exception);
+            }
+            return std::noop_coroutine();
+        }
+        void await_resume() const noexcept {}
+    };
+    return Final {};
+}
+
+inline auto Scenario::operator co_await() && noexcept {
+    struct Awaiter {
+        std::coroutine_handle<promise_type> child;
+
+        bool await_ready() const noexcept { return !child || child.done(); }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> parent) noexcept {
+            child.promise().continuation = parent;
+            return child;
+        }
+        void await_resume() const {
+            if (child && child.promise().exception) {
+                std::rethrow_exception(child.promise().exception);
+            }
+        }
+    };
+    return Awaiter {handle_};
+}
+
+} // namespace elevator
@@ -14,9 +14,15 @@
  * |    9   | request to move the elevator downwards                                         |
  * |   10   | target door state (0: closed, 1: open)                                         |
  * |   11   | request to clear the pending bit from active call memory for the current floor |
- * | 13..12 | condition select index                                                         |
- * |   14   | activates the inversion of the value of the selected condition value           |
+ * | 14..12 | condition select index                                                         |
+ * |   15   | activates the inversion of the value of the selected condition value           |
  * +--------+--------------------------------------------------------------------------------+
+ *
+ * If the condition select index is the packed condition vector (@see condsel.h), the instruction
+ * is a multi-way dispatch: the jump address is the base of a per-state jump table in ProgMem, and
+ * the next PC is loaded from the table entry indexed by the packed condition vector. The inversion
+ * bit widens the key from the three call bits (8 entries) to include the door bit (16 entries).
+ * Table entries are plain addresses and are never executed.
  */
 
 #ifdef __cplusplus
@@ -30,6 +36,37 @@ extern "C" {
 #include <stdint.h>
 #include <stdbool.h>
 
+/* Number of instructions of a program image. */
+#define SEQNET_PROG_MEM_SIZE  256U
+
+/* Fields of the instruction word (@see documentation). */
+#define SEQNET_FIELD_JUMP_ADDR   0x00FFU
+#define SEQNET_FIELD_MOVE_UP     (1U << 8)
+#define SEQNET_FIELD_MOVE_DOWN   (1U << 9)
+#define SEQNET_FIELD_DOOR_OPEN   (1U << 10)
+#define SEQNET_FIELD_RESET       (1U << 11)
+#define SEQNET_FIELD_REQUESTS    (SEQNET_FIELD_MOVE_UP | SEQNET_FIELD_MOVE_DOWN | SEQNET_FIELD_DOOR_OPEN | SEQNET_FIELD_RESET)
+#define SEQNET_FIELD_COND_SEL    0x7000U
+#define SEQNET_FIELD_INV         (1U << 15)
+
+#define SEQNET_SHIFT_REQUESTS    8U
+#define SEQNET_SHIFT_COND_SEL    12U
+
+/* Accessors reading one field of an instruction word, without decoding the others. */
+#define SEQNET_JUMP_ADDR(word)   ((uint8_t)((word) & SEQNET_FIELD_JUMP_ADDR))
+#define SEQNET_MOVE_UP(word)     (((word) & SEQNET_FIELD_MOVE_UP) != 0U)
+#define SEQNET_MOVE_DOWN(word)   (((word) & SEQNET_FIELD_MOVE_DOWN) != 0U)
+#define SEQNET_DOOR_OPEN(word)   (((word) & SEQNET_FIELD_DOOR_OPEN) != 0U)
+#define SEQNET_RESET(word)       (((word) & SEQNET_FIELD_RESET) != 0U)
+#define SEQNET_COND_SEL(word)    ((uint8_t)(((word) & SEQNET_FIELD_COND_SEL) >> SEQNET_SHIFT_COND_SEL))
+#define SEQNET_COND_INV(word)    (((word) & SEQNET_FIELD_INV) != 0U)
+
+/* Packed output byte of the requests: bit 0 up, bit 1 down, bit 2 door open, bit 3 reset. */
+#define SEQNET_REQUESTS(word)    ((uint8_t)(((word) & SEQNET_FIELD_REQUESTS) >> SEQNET_SHIFT_REQUESTS))
+
+/* Instruction word before the first step, its condition is always false. */
+#define SEQNET_POWER_UP_INSTRUCTION  ((uint16_t)(7U << SEQNET_SHIFT_COND_SEL))
+
 typedef struct {
 	bool cond_inv;        /* Condition value inversion */
 	uint8_t cond_sel;     /* Condition value selection */
@@ -37,19 +74,77 @@ typedef struct {
 	bool req_door_state;  /* Request to open the door (request to close if false) */
 	bool req_move_down;   /* Request to move the elevator to a lower level */
 	bool req_move_up;     /* Request to move the elevator to a higher level */
-	uint8_t jump_addr;    /* Address to jump if condition result is active */
+	uint8_t jump_addr;    /* Address to jump if condition result is active (jump table base if dispatch) */
+	bool dispatch;        /* Multi-way dispatch, the next condition value is the packed condition vector */
 } SeqNet_Out;
 
+/** State of a sequential network instance. */
+typedef struct {
+	uint8_t pc;           /* Program counter */
+} SeqNet_State;
+
 /** Initializes the sequential network internal state.
   * Note: needs to be called only once at startup
   */
 SEQNET_API void SeqNet_init(void);
 
 /** Steps the sequential network to the next state.
-  * @param[in] condition_active  True, if the selected condition value is active (or inactive if inversion is activate)
+  * @param[in] condition  Condition value of the previous instruction (@see CondSel_eval). For conditional
+  *                       instructions non-zero if the selected condition value is active (or inactive if
+  *                       inversion is activate), for dispatch instructions the packed condition vector.
+  * @return Returns with the new instruction values (@see SeqNet_Out).
+  */
+SEQNET_API SeqNet_Out SeqNet_loop(const uint8_t condition);
+
+/** Initializes the state of an instance, for running several controllers side by side.
+  * The functions without a state parameter operate on a built-in default instance.
+  * @param[out] state  State of the instance.
+  */
+SEQNET_API void SeqNet_init_state(SeqNet_State *state);
+
+/** Same as SeqNet_loop(), on the given instance.
+  * @param[in,out] state      State of the instance.
+  * @param[in]     condition  Condition value of the previous instruction (@see SeqNet_loop).
   * @return Returns with the new instruction values (@see SeqNet_Out).
   */
-SEQNET_API SeqNet_Out SeqNet_loop(const bool condition_active);
+SEQNET_API SeqNet_Out SeqNet_step(SeqNet_State *state, const uint8_t condition);
+
+/** Same as SeqNet_step(), returning the instruction word without decoding it.
+  * @param[in,out] state      State of the instance.
+  * @param[in]     condition  Condition value of the previous instruction (@see SeqNet_loop).
+  * @return Returns with the new 16-bit instruction word (@see documentation).
+  */
+SEQNET_API uint16_t SeqNet_step_raw(SeqNet_State *state, const uint8_t condition);
+
+/** Same as SeqNet_step_raw(), running the given program image instead of the built-in program.
+  * @param[in]     image      Program image of SEQNET_PROG_MEM_SIZE instruction words.
+  * @param[in,out] state      State of the instance.
+  * @param[in]     condition  Condition value of the previous instruction (@see SeqNet_loop).
+  * @return Returns with the new 16-bit instruction word (@see documentation).
+  */
+SEQNET_API uint16_t SeqNet_step_image(const uint16_t *image, SeqNet_State *state, const uint8_t condition);
+
+/** Gives access to the built-in program, e.g. as the reference for a rewritten program image.
+  * @return Returns with the built-in program image of SEQNET_PROG_MEM_SIZE instruction words.
+  */
+SEQNET_API const uint16_t *SeqNet_program(void);
+
+/** Decodes an instruction word into its fields.
+  * @param[in] instruction  16-bit instruction word (@see documentation).
+  * @return Returns with the decoded instruction (@see SeqNet_Out).
+  */
+SEQNET_API SeqNet_Out SeqNet_decode(const uint16_t instruction);
+
+/** Encodes the fields of an instruction back into the instruction word (@see documentation).
+  * @param[in] out  Decoded instruction.
+  * @return Returns with the 16-bit instruction word.
+  */
+SEQNET_API uint16_t SeqNet_encode(const SeqNet_Out *out);
+
+/** Reads the program counter of the default instance, e.g. for telemetry.
+  * @return Returns with the address of the current instruction.
+  */
+SEQNET_API uint8_t SeqNet_get_pc(void);
 
 #ifdef __cplusplus
 }
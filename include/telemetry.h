@@ -0,0 +1,122 @@
+#pragma once
+
+/** Live telemetry module
+ * This component publishes the state of the controller and the simulation into a POSIX shared
+ * memory segment, one record per car. Every record is protected by its own sequence lock: the
+ * writer never waits, readers retry if they raced with an update. Readers map the segment
+ * read-only, so any number of them can sample at any rate without slowing the writer.
+ *
+ * Segment layout: a Telemetry_Header followed by the records, each on its own cache line.
+ * Note: only available on POSIX systems, the functions fail with -ENOSYS elsewhere.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef TELEMETRY_API
+#define TELEMETRY_API extern
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define TELEMETRY_MAGIC    0x4D544C45UL  /* "ELTM" */
+#define TELEMETRY_VERSION  2U
+
+/* Values of Telemetry_Data.door. */
+#define TELEMETRY_DOOR_OPEN    0U
+#define TELEMETRY_DOOR_CLOSED  1U
+
+/* Values of Telemetry_Data.movement. */
+#define TELEMETRY_MOVEMENT_STOPPED  0U
+#define TELEMETRY_MOVEMENT_UP       1U
+#define TELEMETRY_MOVEMENT_DOWN     2U
+
+/** Published state of a car. */
+typedef struct {
+	uint64_t cycle;          /* Number of control cycles run */
+	uint32_t pending_calls;  /* Pending calls, bit n: floor n */
+	uint8_t pc;              /* Program counter of the controller */
+	uint8_t floor;           /* Current floor */
+	uint8_t door;            /* Door state (TELEMETRY_DOOR_*) */
+	uint8_t movement;        /* Movement state (TELEMETRY_MOVEMENT_*) */
+} Telemetry_Data;
+
+/* Number of 32-bit words of the published data. */
+#define TELEMETRY_DATA_WORDS  ((sizeof(Telemetry_Data) + 3U) / 4U)
+
+/** Header at the start of the segment. */
+typedef struct {
+	uint32_t magic;          /* TELEMETRY_MAGIC */
+	uint32_t version;        /* TELEMETRY_VERSION */
+	uint32_t record_count;   /* Number of records */
+	uint32_t record_size;    /* Distance of the records in bytes */
+} Telemetry_Header;
+
+/** A record of the segment. */
+typedef struct {
+	uint32_t seq;                          /* Sequence lock, odd while the record is written, wraps */
+	uint32_t published;                    /* Non-zero once the record was published */
+	uint32_t words[TELEMETRY_DATA_WORDS];  /* Telemetry_Data */
+} Telemetry_Record;
+
+/** Handle of a mapped segment. */
+typedef struct {
+	void *base;              /* Start of the mapping, NULL if not mapped */
+	size_t size;             /* Size of the mapping */
+	uint32_t record_count;   /* Number of records */
+	bool writer;             /* Created by Telemetry_create() */
+	char name[64];           /* Name of the shared memory object */
+} Telemetry;
+
+/** Creates a segment and maps it for writing. All records start empty.
+  * An existing segment of the same name is never replaced (@see Telemetry_remove).
+  * @param[out] telemetry     Handle of the segment.
+  * @param[in]  name          Name of the shared memory object, e.g. "/elevator".
+  * @param[in]  record_count  Number of records (cars).
+  * @return Returns with 0 on success, with -EEXIST if the segment exists (e.g. another writer is
+  *         running), with a negative errno value otherwise.
+  */
+TELEMETRY_API int Telemetry_create(Telemetry *telemetry, const char *name, const uint32_t record_count);
+
+/** Maps an existing segment read-only.
+  * @param[out] telemetry  Handle of the segment.
+  * @param[in]  name       Name of the shared memory object.
+  * @return Returns with 0 on success, with a negative errno value otherwise (-EPROTO if the
+  *         segment has an unknown layout).
+  */
+TELEMETRY_API int Telemetry_open(Telemetry *telemetry, const char *name);
+
+/** Unmaps the segment. The writer also removes the shared memory object.
+  * @param[in,out] telemetry  Handle of the segment.
+  */
+TELEMETRY_API void Telemetry_close(Telemetry *telemetry);
+
+/** Removes a segment left behind by a writer which did not close it, e.g. after a crash.
+  * Readers still attached keep their mapping.
+  * @param[in] name  Name of the shared memory object.
+  * @return Returns with 0 on success, with a negative errno value otherwise (-ENOENT if there is none).
+  */
+TELEMETRY_API int Telemetry_remove(const char *name);
+
+/** Publishes the state of a car. Must only be called by the single writer.
+  * @param[in,out] telemetry  Handle of the segment (created by Telemetry_create()).
+  * @param[in]     record     Index of the record, ignored if out of range.
+  * @param[in]     data       State to publish.
+  */
+TELEMETRY_API void Telemetry_publish(Telemetry *telemetry, const uint32_t record, const Telemetry_Data *data);
+
+/** Reads a consistent snapshot of a record without blocking the writer.
+  * @param[in]  telemetry  Handle of the segment.
+  * @param[in]  record     Index of the record.
+  * @param[out] data       Receives the snapshot.
+  * @return Returns false if the record is out of range, was never published, or no consistent
+  *         snapshot could be taken within a bounded number of retries.
+  */
+TELEMETRY_API bool Telemetry_read(const Telemetry *telemetry, const uint32_t record, Telemetry_Data *data);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,9 +1,28 @@
+#include <errno.h>
+#include <signal.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "seqnet.h"
 #include "condsel.h"
+#include "controller.h"
+#include "lockstep.h"
+#include "posdet.h"
+#include "callq.h"
+#include "histo.h"
+#include "rtloop.h"
+#include "telemetry.h"
+#include "recorder.h"
+#include "hil.h"
+#include "kpi.h"
 
 #define NUM_FLOORS 6U
 
+/* Defaults and call rate of the real-time mode. */
+#define RT_DEFAULT_PERIOD_US  1000U
+#define RT_DEFAULT_CYCLES     10000U
+#define RT_CALL_INTERVAL      40U
+
 /* Represents the state of the doors. */
 typedef enum
 {
@@ -25,42 +44,97 @@ typedef struct
     uint8_t current_floor;
     DoorStatus door_status;
     MovementStatus movement_status;
-    bool pending_calls[NUM_FLOORS];
+    CallQ calls;                      /* Calls posted by the input sources */
+    bool pending_calls[NUM_FLOORS];   /* Calls taken over by the control loop */
 } ElevatorSimulation;
 
-/* Variable to store previous condition state. */
-static bool condition_active = false;
+/* Workload of the real-time mode. */
+typedef struct
+{
+    ElevatorSimulation sim;
+    uint32_t cycle;
+    uint32_t seed;
+} RtWorkload;
+
+/* Controller of the car. */
+static Controller controller;
+
+/* Redundant controller of the car, used instead of the controller in the lockstep mode. */
+static Lockstep lockstep;
+static bool lockstep_mode = false;
+
+/* Packed sensor word sensed after the previous cycle. */
+static uint8_t sensed = 0U;
+
+/* Set by SIGINT or SIGTERM, the real-time mode stops after the current cycle. */
+static volatile sig_atomic_t stop_requested = 0;
+
+/* Number of control cycles run. */
+static uint64_t cycle_count = 0U;
+
+/* Live telemetry segment, only mapped if requested on the command line. */
+static Telemetry telemetry;
+
+/* Input recording, only written if requested on the command line. */
+static Recorder recorder;
+
+/* Names of the runs with their own service KPIs: the test scenarios and the real-time mode. */
+static const char *const kpi_names[] = {
+    "TEST 1: Call to Floor 3",
+    "TEST 2: Calls to Floor 5 and 1",
+    "TEST 3: Calls to Floor 5 and 1 from Floor 3",
+    "TEST 4: Call during movement",
+    "TEST 5: Call to Floor 0",
+    "Real-time"};
+#define KPI_RUNS  (sizeof(kpi_names) / sizeof(kpi_names[0]))
+#define KPI_RT    (KPI_RUNS - 1U)
+
+/* Service KPIs of the runs, and the ones of the current run. */
+static Kpi kpis[KPI_RUNS];
+static Kpi *kpi = &kpis[0];
 
 /**
  * @brief initialises the simulator.
  */
 static void init_simulation()
 {
-    SeqNet_init();
-    condition_active = false;
+    Controller_init(&controller);
+    Lockstep_init(&lockstep);
+    Recorder_reset(&recorder);
+    sensed = 0U;
+}
+
+/**
+ * @brief Starts the service KPIs of a run.
+ * @param run Index of the run in kpi_names.
+ */
+static void start_kpi(uint32_t run)
+{
+    kpi = &kpis[run];
+    Kpi_init(kpi, NUM_FLOORS);
 }
 
 /**
  * @brief Updates the state of the elevator based on the requests.
  * @param sim The elevator simulation state to update.
- * @param controller_out The requests from the sequential network controller.
+ * @param instruction The instruction word of the controller with the requests.
  */
-static void update_simulation(ElevatorSimulation *sim, const SeqNet_Out *controller_out)
+static void update_simulation(ElevatorSimulation *sim, const uint16_t instruction)
 {
     /* Handle Door Logic only when movement is stopped. */
     if (sim->movement_status == MOVEMENT_STOPPED)
     {
-        sim->door_status = controller_out->req_door_state ? DOOR_STATE_OPEN : DOOR_STATE_CLOSED;
+        sim->door_status = SEQNET_DOOR_OPEN(instruction) ? DOOR_STATE_OPEN : DOOR_STATE_CLOSED;
     }
 
     /* Handle Movement Logic only when the door is closed. */
     if (sim->door_status == DOOR_STATE_CLOSED)
     {
-        if (controller_out->req_move_up && (sim->current_floor < (NUM_FLOORS - 1U)))
+        if (SEQNET_MOVE_UP(instruction) && (sim->current_floor < (NUM_FLOORS - 1U)))
         {
             sim->movement_status = MOVEMENT_UP;
         }
-        else if (controller_out->req_move_down && (sim->current_floor > 0U))
+        else if (SEQNET_MOVE_DOWN(instruction) && (sim->current_floor > 0U))
         {
             sim->movement_status = MOVEMENT_DOWN;
         }
@@ -85,30 +159,90 @@ static void update_simulation(ElevatorSimulation *sim, const SeqNet_Out *control
     }
 
     /* Handle Pending Call Reset Request. */
-    if (controller_out->req_reset)
+    if (SEQNET_RESET(instruction) && sim->pending_calls[sim->current_floor])
     {
         sim->pending_calls[sim->current_floor] = false;
+        CallQ_ack(&sim->calls, sim->current_floor);
     }
 }
 
 /**
- * @brief Runs the simulation until there are no pending calls and the door is open.
+ * @brief Takes over the calls posted since the previous cycle.
+ * @param sim The elevator simulation state to update.
+ */
+static void take_posted_calls(ElevatorSimulation *sim)
+{
+    uint32_t posted = CallQ_drain(&sim->calls);
+
+    for (uint8_t k = 0U; k < NUM_FLOORS; k++)
+    {
+        if ((posted & ((uint32_t)1U << k)) != 0U)
+        {
+            sim->pending_calls[k] = true;
+            Kpi_call(kpi, k);
+        }
+    }
+}
+
+/**
+ * @brief Publishes the state of the controller and the simulation (no-op without a segment).
  * @param sim The elevator simulation state.
- * @param max_steps The maximum number of simulation cycles to run.
  */
-static void run_simulation_steps(ElevatorSimulation *sim, uint16_t max_steps)
+static void publish_telemetry(const ElevatorSimulation *sim)
+{
+    Telemetry_Data data;
+
+    data.cycle = cycle_count;
+    data.pending_calls = 0U;
+    for (uint8_t k = 0U; k < NUM_FLOORS; k++)
+    {
+        data.pending_calls |= sim->pending_calls[k] ? ((uint32_t)1U << k) : 0U;
+    }
+    data.pc = lockstep_mode ? lockstep.channel.state.pc : controller.state.pc;
+    data.floor = sim->current_floor;
+    data.door = (sim->door_status == DOOR_STATE_OPEN) ? TELEMETRY_DOOR_OPEN : TELEMETRY_DOOR_CLOSED;
+    data.movement = (sim->movement_status == MOVEMENT_UP) ? TELEMETRY_MOVEMENT_UP :
+                    (sim->movement_status == MOVEMENT_DOWN) ? TELEMETRY_MOVEMENT_DOWN : TELEMETRY_MOVEMENT_STOPPED;
+
+    Telemetry_publish(&telemetry, 0U, &data);
+}
+
+/**
+ * @brief Runs one control cycle: sense, select the condition, step the controller and actuate.
+ * @param sim The elevator simulation state.
+ * @param verbose Print the state of the simulation after the cycle.
+ * @return True if no calls are pending and the door is open.
+ */
+static bool step_simulation(ElevatorSimulation *sim, bool verbose)
 {
-    SeqNet_Out controller_outputs = {0};
     bool any_calls_pending = false;
 
-    for (uint16_t i = 0U; i < max_steps; i++)
+    /* Take over the calls of the input sources. */
+    take_posted_calls(sim);
+
+    /* Step the controller on the sensor word of the previous cycle to get new requests. */
+    uint16_t instruction = 0U;
+    if (lockstep_mode)
     {
-        /* Step the controller to get new requests. */
-        controller_outputs = SeqNet_loop(condition_active);
+        bool stopped = lockstep.safe_stop;
+        instruction = Lockstep_step(&lockstep, sensed);
+        if (lockstep.safe_stop && !stopped)
+        {
+            fprintf(stderr, "Lockstep channels disagree in cycle %llu, safe stop\n", (unsigned long long)cycle_count);
+        }
+    }
+    else
+    {
+        instruction = Controller_step(&controller, sensed);
+    }
 
-        /* Update the simulation based on the controller's requests. */
-        update_simulation(sim, &controller_outputs);
+    /* Update the simulation based on the controller's requests. */
+    update_simulation(sim, instruction);
+    Kpi_cycle(kpi, sim->current_floor, sim->door_status == DOOR_STATE_OPEN,
+              sim->movement_status != MOVEMENT_STOPPED, SEQNET_RESET(instruction));
 
+    if (verbose)
+    {
         printf(" Floor=%d, Movement=%d, Door=%s, Calls=",
                      sim->current_floor,
                      sim->movement_status,
@@ -119,38 +253,59 @@ static void run_simulation_steps(ElevatorSimulation *sim, uint16_t max_steps)
             printf("%d", sim->pending_calls[j]);
         }
         printf("\n");
+    }
 
-        /* Prepare the inputs for the next controller cycle. */
-        CondSel_In condition_inputs = {false, false, false, false, false};
-        condition_inputs.door_open = (sim->door_status == DOOR_STATE_OPEN);
-        condition_inputs.door_closed = (sim->door_status == DOOR_STATE_CLOSED);
+    /* Prepare the inputs for the next controller cycle. */
+    CondSel_In condition_inputs = {false, false, false, false, false};
+    condition_inputs.door_open = (sim->door_status == DOOR_STATE_OPEN);
+    condition_inputs.door_closed = (sim->door_status == DOOR_STATE_CLOSED);
 
-        any_calls_pending = false;
-        for (uint8_t k = 0U; k < NUM_FLOORS; k++)
+    for (uint8_t k = 0U; k < NUM_FLOORS; k++)
+    {
+        if (sim->pending_calls[k])
         {
-            if (sim->pending_calls[k])
+            any_calls_pending = true;
+            if (k > sim->current_floor)
+            {
+                condition_inputs.call_pending_above = true;
+            }
+            else if (k < sim->current_floor)
             {
-                any_calls_pending = true;
-                if (k > sim->current_floor)
-                {
-                    condition_inputs.call_pending_above = true;
-                }
-                else if (k < sim->current_floor)
-                {
-                    condition_inputs.call_pending_below = true;
-                }
-                else
-                {
-                    condition_inputs.call_pending_same = true;
-                }
+                condition_inputs.call_pending_below = true;
+            }
+            else
+            {
+                condition_inputs.call_pending_same = true;
             }
         }
+    }
+
+    /* Sample the position checks together with the other inputs of the cycle, the controller
+     * evaluates the condition of the instruction on them in the next loop. */
+    sensed = CondSel_pack(condition_inputs, PosDet_is_elevator_position_ok(), PosDet_is_door_position_ok());
 
-        /* Calculate the condition result that the controller will use in the next loop. */
-        condition_active = CondSel_calc(controller_outputs.cond_inv, controller_outputs.cond_sel, condition_inputs);
+    Recorder_cycle(&recorder, sensed, instruction);
 
+    cycle_count++;
+    if (telemetry.base != NULL)
+    {
+        publish_telemetry(sim);
+    }
+
+    return (any_calls_pending == false) && (sim->door_status == DOOR_STATE_OPEN);
+}
+
+/**
+ * @brief Runs the simulation until there are no pending calls and the door is open.
+ * @param sim The elevator simulation state.
+ * @param max_steps The maximum number of simulation cycles to run.
+ */
+static void run_simulation_steps(ElevatorSimulation *sim, uint16_t max_steps)
+{
+    for (uint16_t i = 0U; i < max_steps; i++)
+    {
         /* Stop if no calls are pending and the door is open. */
-        if ((any_calls_pending == false) && (sim->door_status == DOOR_STATE_OPEN))
+        if (step_simulation(sim, true))
         {
             printf("\nTest finished\n");
             break;
@@ -158,66 +313,454 @@ static void run_simulation_steps(ElevatorSimulation *sim, uint16_t max_steps)
     }
 }
 
-int main(void)
+/**
+ * @brief Input source of the real-time mode: posts a call to a pseudo-random floor periodically.
+ * @param context The real-time workload (RtWorkload).
+ * @return False once a stop was requested by a signal, true otherwise.
+ */
+static bool rt_cycle(void *context)
+{
+    RtWorkload *workload = (RtWorkload *)context;
+
+    if ((workload->cycle % RT_CALL_INTERVAL) == 0U)
+    {
+        workload->seed = (workload->seed * 1103515245U) + 12345U;
+        (void)CallQ_post(&workload->sim.calls, (uint8_t)((workload->seed >> 16) % NUM_FLOORS), NULL);
+    }
+    workload->cycle++;
+
+    (void)step_simulation(&workload->sim, false);
+
+    return stop_requested == 0;
+}
+
+/**
+ * @brief Signal handler of the real-time mode, requests the runner to stop.
+ * @param signal_number The received signal.
+ */
+static void request_stop(int signal_number)
+{
+    (void)signal_number;
+    stop_requested = 1;
+}
+
+/**
+ * @brief Prints the percentiles and the non-empty buckets of a histogram.
+ * @param name Name of the histogram.
+ * @param histo The histogram to print.
+ */
+static void print_histogram(const char *name, const Histo *histo)
+{
+    printf("%s: samples=%llu", name, (unsigned long long)histo->total);
+    if (histo->total == 0U)
+    {
+        printf("\n");
+        return;
+    }
+
+    printf(" min=%llu p50=%llu p99=%llu p99.9=%llu max=%llu (ns)\n",
+           (unsigned long long)histo->min,
+           (unsigned long long)Histo_percentile(histo, 50.0),
+           (unsigned long long)Histo_percentile(histo, 99.0),
+           (unsigned long long)Histo_percentile(histo, 99.9),
+           (unsigned long long)histo->max);
+
+    for (uint32_t i = 0U; i < HISTO_BUCKETS; i++)
+    {
+        if (histo->counts[i] != 0U)
+        {
+            printf("  %12llu .. %12llu: %llu\n",
+                   (unsigned long long)Histo_bucket_low(i),
+                   (unsigned long long)Histo_bucket_high(i),
+                   (unsigned long long)histo->counts[i]);
+        }
+    }
+}
+
+/**
+ * @brief Runs the controller on the simulation at a fixed period and reports the timing.
+ * @param config The configuration of the runner.
+ * @return Exit code of the application.
+ */
+static int run_real_time(const RtLoop_Config *config)
+{
+    static RtWorkload workload;
+    static RtLoop_Stats stats;
+
+    workload.sim.current_floor = 0U;
+    workload.sim.door_status = DOOR_STATE_OPEN;
+    workload.sim.movement_status = MOVEMENT_STOPPED;
+    CallQ_init(&workload.sim.calls);
+    workload.cycle = 0U;
+    workload.seed = 1U;
+    init_simulation();
+    start_kpi(KPI_RT);
+
+    if (config->cycles == 0U)
+    {
+        printf("Running until SIGINT or SIGTERM");
+    }
+    else
+    {
+        printf("Running %llu cycles", (unsigned long long)config->cycles);
+    }
+    printf(", period=%lluns, fifo=%d, cpu=%d, mlock=%d\n",
+           (unsigned long long)config->period_ns,
+           config->fifo_priority,
+           config->cpu,
+           config->lock_memory);
+
+    /* A signal ends the run after the current cycle, so the report is still printed. */
+    stop_requested = 0;
+    (void)signal(SIGINT, request_stop);
+    (void)signal(SIGTERM, request_stop);
+    int result = RtLoop_run(config, rt_cycle, &workload, &stats);
+    (void)signal(SIGINT, SIG_DFL);
+    (void)signal(SIGTERM, SIG_DFL);
+
+    if (result != 0)
+    {
+        fprintf(stderr, "Real-time runner failed: %s\n", strerror(-result));
+        return 1;
+    }
+
+    printf("Cycles=%llu, Overruns=%llu, Missed releases=%llu\n",
+           (unsigned long long)stats.cycles,
+           (unsigned long long)stats.overruns,
+           (unsigned long long)stats.missed);
+    print_histogram("Period jitter", &stats.jitter);
+    print_histogram("Execution time", &stats.exec);
+    print_histogram("Overrun", &stats.overrun);
+
+    return 0;
+}
+
+/**
+ * @brief Runs the controllers as a hardware-in-the-loop gateway for a plant in another process.
+ * @param address The address of the gateway (unix:PATH or shm:NAME).
+ * @return Exit code of the application.
+ */
+static int run_gateway(const char *address)
+{
+    static HIL_Stats stats;
+    HIL_Link link;
+
+    printf("Waiting for the plant on %s\n", address);
+    int result = HIL_serve(&link, address, HIL_TIMEOUT_MS);
+    if (result == 0)
+    {
+        result = HIL_run_gateway(&link, &stats);
+    }
+    HIL_close(&link);
+
+    if (result != 0)
+    {
+        fprintf(stderr, "Gateway %s failed after %llu ticks: %s\n", address,
+                (unsigned long long)stats.ticks, strerror(-result));
+        return 1;
+    }
+
+    printf("Ticks=%llu\n", (unsigned long long)stats.ticks);
+    print_histogram("Plant turnaround", &stats.rtt);
+
+    return 0;
+}
+
+/**
+ * @brief Parses an unsigned integer option value.
+ * @param text The text to parse.
+ * @param value Receives the value.
+ * @return True if the whole text is a valid number.
+ */
+static bool parse_number(const char *text, unsigned long long *value)
+{
+    char *end = NULL;
+
+    if ((text == NULL) || (*text == '\0'))
+    {
+        return false;
+    }
+
+    *value = strtoull(text, &end, 10);
+    return *end == '\0';
+}
+
+/**
+ * @brief Prints the command line usage.
+ * @param program Name of the executable.
+ */
+static void print_usage(const char *program)
+{
+    fprintf(stderr,
+            "Usage: %s [--telemetry NAME [--telemetry-replace]] [--record FILE] [--kpi FILE] [--lockstep] [--rt [--period-us N] [--cycles N] [--fifo PRIO] [--cpu N] [--mlock]]\n"
+            "       %s --hil ADDRESS\n"
+            "  Without --rt or --hil the test scenarios are run.\n"
+            "  --telemetry NAME publish live state to the shared memory object NAME (e.g. /elevator)\n"
+            "  --telemetry-replace remove a stale segment NAME left behind by a crashed emulator\n"
+            "  --record FILE    record the controller inputs and outputs for elevator_replay\n"
+            "  --kpi FILE       write the call service, door dwell and travel histograms as JSON\n"
+            "  --lockstep       run the controller in two redundant channels, compared every cycle\n"
+            "  --rt          run the control loop at a fixed period and report the timing\n"
+            "  --period-us N period of the control loop in microseconds (default: %u)\n"
+            "  --cycles N    number of cycles to run, 0 until SIGINT or SIGTERM (default: %u)\n"
+            "  --fifo PRIO   run with SCHED_FIFO at the given priority\n"
+            "  --cpu N       pin the control loop to the given CPU\n"
+            "  --mlock       lock the memory of the process\n"
+            "  --hil ADDRESS serve the controllers to a plant process (e.g. elevator_plant) on\n"
+            "                unix:PATH or shm:NAME, one controller per car of the plant\n",
+            program, program, RT_DEFAULT_PERIOD_US, RT_DEFAULT_CYCLES);
+}
+
+/**
+ * @brief Writes the service KPIs of runs as JSON.
+ * @param path Name of the file, "-" for stdout.
+ * @param first Index of the first run in kpi_names.
+ * @param count Number of runs.
+ * @return True on success.
+ */
+static bool write_kpis(const char *path, uint32_t first, uint32_t count)
+{
+    FILE *file = (strcmp(path, "-") == 0) ? stdout : fopen(path, "w");
+    if (file == NULL)
+    {
+        fprintf(stderr, "KPI file %s failed: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    int result = Kpi_write_json(file, &kpis[first], &kpi_names[first], count);
+    if ((file != stdout) && (fclose(file) != 0) && (result == 0))
+    {
+        result = -errno;
+    }
+    if (result != 0)
+    {
+        fprintf(stderr, "KPI file %s failed: %s\n", path, strerror(-result));
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Runs the test scenarios.
+ */
+static void run_scenarios(void)
 {
     ElevatorSimulation sim = {
         .current_floor = 0U,
         .door_status = DOOR_STATE_OPEN,
         .movement_status = MOVEMENT_STOPPED,
         .pending_calls = {false}};
+    CallQ_init(&sim.calls);
 
     /* TEST 1: Call from floor 0 to floor 3. */
     printf("\nTEST 1: Call to Floor 3\n");
+    start_kpi(0U);
     sim.current_floor = 0U;
     sim.door_status = DOOR_STATE_OPEN;
     sim.movement_status = MOVEMENT_STOPPED;
-    sim.pending_calls[3] = true;
+    (void)CallQ_post(&sim.calls, 3U, NULL);
     init_simulation();
     run_simulation_steps(&sim, 100U);
 
     /* TEST 2: Multiple pending calls (floor 5, then floor 1). */
     printf("\nTEST 2: Calls to Floor 5 and 1\n");
+    start_kpi(1U);
     sim.current_floor = 0U;
     sim.door_status = DOOR_STATE_OPEN;
     sim.movement_status = MOVEMENT_STOPPED;
-    sim.pending_calls[1] = true;
-    sim.pending_calls[5] = true;
+    (void)CallQ_post(&sim.calls, 1U, NULL);
+    (void)CallQ_post(&sim.calls, 5U, NULL);
     init_simulation();
     run_simulation_steps(&sim, 100U);
 
     /* TEST 3: Multiple pending calls, starting from floor 3 (floor 5, then floor 1). */
     printf("\nTEST 3:Calls to Floor 5 and 1 from Floor 3\n");
+    start_kpi(2U);
     sim.current_floor = 3U;
     sim.door_status = DOOR_STATE_OPEN;
     sim.movement_status = MOVEMENT_STOPPED;
-    sim.pending_calls[1] = true;
-    sim.pending_calls[5] = true;
+    (void)CallQ_post(&sim.calls, 1U, NULL);
+    (void)CallQ_post(&sim.calls, 5U, NULL);
     init_simulation();
     run_simulation_steps(&sim, 100U);
 
 
     /* TEST 4: New call during movement. */
     printf("\nTEST 4: Call during movement\n");
+    start_kpi(3U);
     sim.current_floor = 0U;
     sim.door_status = DOOR_STATE_OPEN;
     sim.movement_status = MOVEMENT_STOPPED;
-    sim.pending_calls[5] = true;
+    (void)CallQ_post(&sim.calls, 5U, NULL);
     init_simulation();
     run_simulation_steps(&sim, 10U);
 
     printf("\nADDING NEW CALL TO 0 MID-TRIP\n");
-    sim.pending_calls[0] = true;
+    (void)CallQ_post(&sim.calls, 0U, NULL);
     run_simulation_steps(&sim, 100U);
 
     /* TEST 5: Call from floor 0 to floor 0. */
     printf("\nTEST 5: Call to Floor 0\n");
+    start_kpi(4U);
     sim.current_floor = 0U;
     sim.door_status = DOOR_STATE_OPEN;
     sim.movement_status = MOVEMENT_STOPPED;
-    sim.pending_calls[0] = true;
+    (void)CallQ_post(&sim.calls, 0U, NULL);
     init_simulation();
     run_simulation_steps(&sim, 100U);
 
     printf("\nATests finished.\n");
-    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    RtLoop_Config config = {
+        .period_ns = RT_DEFAULT_PERIOD_US * 1000ULL,
+        .cycles = RT_DEFAULT_CYCLES,
+        .fifo_priority = 0,
+        .cpu = -1,
+        .lock_memory = false};
+    bool real_time = false;
+    const char *telemetry_name = NULL;
+    bool telemetry_replace = false;
+    const char *record_path = NULL;
+    const char *hil_address = NULL;
+    const char *kpi_path = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        unsigned long long value = 0U;
+        bool has_value = (i + 1) < argc;
+
+        if (strcmp(argv[i], "--rt") == 0)
+        {
+            real_time = true;
+        }
+        else if (strcmp(argv[i], "--mlock") == 0)
+        {
+            config.lock_memory = true;
+        }
+        else if (strcmp(argv[i], "--lockstep") == 0)
+        {
+            lockstep_mode = true;
+        }
+        else if (strcmp(argv[i], "--telemetry-replace") == 0)
+        {
+            telemetry_replace = true;
+        }
+        else if (has_value && (strcmp(argv[i], "--telemetry") == 0))
+        {
+            telemetry_name = argv[i + 1];
+            i++;
+        }
+        else if (has_value && (strcmp(argv[i], "--record") == 0))
+        {
+            record_path = argv[i + 1];
+            i++;
+        }
+        else if (has_value && (strcmp(argv[i], "--kpi") == 0))
+        {
+            kpi_path = argv[i + 1];
+            i++;
+        }
+        else if (has_value && (strcmp(argv[i], "--hil") == 0))
+        {
+            hil_address = argv[i + 1];
+            i++;
+        }
+        else if (has_value && (strcmp(argv[i], "--period-us") == 0) && parse_number(argv[i + 1], &value) && (value > 0U))
+        {
+            config.period_ns = value * 1000ULL;
+            i++;
+        }
+        else if (has_value && (strcmp(argv[i], "--cycles") == 0) && parse_number(argv[i + 1], &value))
+        {
+            config.cycles = value;
+            i++;
+        }
+        else if (has_value && (strcmp(argv[i], "--fifo") == 0) && parse_number(argv[i + 1], &value) && (value > 0U) && (value < 100U))
+        {
+            config.fifo_priority = (int)value;
+            i++;
+        }
+        else if (has_value && (strcmp(argv[i], "--cpu") == 0) && parse_number(argv[i + 1], &value) && (value < 1024U))
+        {
+            config.cpu = (int)value;
+            i++;
+        }
+        else
+        {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    /* The gateway steps the controllers of the plant's cars, the local simulation does not run. */
+    if (hil_address != NULL)
+    {
+        if (real_time || lockstep_mode || telemetry_replace || (telemetry_name != NULL) || (record_path != NULL) || (kpi_path != NULL))
+        {
+            print_usage(argv[0]);
+            return 2;
+        }
+        return run_gateway(hil_address);
+    }
+
+    if (telemetry_name != NULL)
+    {
+        if (telemetry_replace)
+        {
+            (void)Telemetry_remove(telemetry_name);
+        }
+
+        int result = Telemetry_create(&telemetry, telemetry_name, 1U);
+        if (result == -EEXIST)
+        {
+            fprintf(stderr, "Telemetry segment %s exists, another emulator may be writing it "
+                            "(--telemetry-replace removes a stale one)\n", telemetry_name);
+            return 1;
+        }
+        if (result != 0)
+        {
+            fprintf(stderr, "Telemetry segment %s failed: %s\n", telemetry_name, strerror(-result));
+            return 1;
+        }
+    }
+
+    if (record_path != NULL)
+    {
+        int result = Recorder_open(&recorder, record_path);
+        if (result != 0)
+        {
+            fprintf(stderr, "Recording %s failed: %s\n", record_path, strerror(-result));
+            Telemetry_close(&telemetry);
+            return 1;
+        }
+    }
+
+    int exit_code = 0;
+    if (real_time)
+    {
+        exit_code = run_real_time(&config);
+    }
+    else
+    {
+        run_scenarios();
+    }
+
+    if (kpi_path != NULL)
+    {
+        bool written = real_time ? write_kpis(kpi_path, KPI_RT, 1U) : write_kpis(kpi_path, 0U, KPI_RT);
+        exit_code = written ? exit_code : 1;
+    }
+
+    if (Recorder_close(&recorder) != 0)
+    {
+        fprintf(stderr, "Recording %s is incomplete\n", record_path);
+        exit_code = 1;
+    }
+
+    Telemetry_close(&telemetry);
+    return exit_code;
 }
@@ -0,0 +1,127 @@
+#include "callq.h"
+#include <stddef.h>
+
+/* Posted flag in the generation word of a floor. */
+#define POSTED_FLAG  1U
+
+/* Generation step of a drain that takes a call. Added to a word with the posted flag set, it
+ * clears the flag and moves the generation on in one atomic operation. */
+#define DRAIN_STEP   1U
+
+/**
+ * @brief Initializes the queue.
+ *
+ * @param[out] queue  Queue to initialize.
+ */
+CALLQ_API void CallQ_init(CallQ *queue)
+{
+    __atomic_store_n(&queue->posted, 0U, __ATOMIC_RELAXED);
+
+    for (uint8_t floor = 0U; floor < CALLQ_MAX_FLOORS; floor++)
+    {
+        __atomic_store_n(&queue->generation[floor], 0U, __ATOMIC_RELAXED);
+        __atomic_store_n(&queue->served[floor], 0U, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Posts a call.
+ *
+ * Setting the posted flag returns the generation word before it, so the ticket is the generation
+ * of the next drain that takes a call of the floor, whatever the control loop does meanwhile. The
+ * bit in the bitmap is set afterwards and only tells the drain which floors to look at.
+ *
+ * @param[in,out] queue   Queue to post the call into.
+ * @param[in]     floor   Floor of the call.
+ * @param[out]    ticket  Optional, receives the ticket of the call.
+ * @return False if the floor is out of range.
+ */
+CALLQ_API bool CallQ_post(CallQ *queue, const uint8_t floor, uint32_t *ticket)
+{
+    if (floor >= CALLQ_MAX_FLOORS)
+    {
+        return false;
+    }
+
+    uint32_t generation = __atomic_fetch_or(&queue->generation[floor], POSTED_FLAG, __ATOMIC_ACQ_REL);
+    (void)__atomic_fetch_or(&queue->posted, (uint32_t)1U << floor, __ATOMIC_ACQ_REL);
+
+    if (ticket != NULL)
+    {
+        *ticket = (generation & ~POSTED_FLAG) + 2U;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Checks whether the call of a ticket was served.
+ *
+ * @param[in] queue   Queue the call was posted into.
+ * @param[in] floor   Floor of the call.
+ * @param[in] ticket  Ticket returned by CallQ_post().
+ * @return True if the served generation reached the ticket.
+ */
+CALLQ_API bool CallQ_is_served(const CallQ *queue, const uint8_t floor, const uint32_t ticket)
+{
+    if (floor >= CALLQ_MAX_FLOORS)
+    {
+        return false;
+    }
+
+    /* Generations wrap, the difference tells which one is later. */
+    return (int32_t)(__atomic_load_n(&queue->served[floor], __ATOMIC_ACQUIRE) - ticket) >= 0;
+}
+
+/**
+ * @brief Takes all posted calls.
+ *
+ * A bit of the bitmap may outlive the posted flag of its floor: a call posted while the drain
+ * takes an earlier one of the same floor is taken over with it, before its bit is set. Such a
+ * bit is dropped.
+ *
+ * @param[in,out] queue  Queue to drain.
+ * @return Bitmap of the posted calls.
+ */
+CALLQ_API uint32_t CallQ_drain(CallQ *queue)
+{
+    /* Cheap check first, so an idle cycle does not need to own the cache line. */
+    if (__atomic_load_n(&queue->posted, __ATOMIC_RELAXED) == 0U)
+    {
+        return 0U;
+    }
+
+    uint32_t posted = __atomic_exchange_n(&queue->posted, 0U, __ATOMIC_ACQ_REL);
+    uint32_t taken = 0U;
+
+    for (uint8_t floor = 0U; floor < CALLQ_MAX_FLOORS; floor++)
+    {
+        /* Only the drain clears the flag, a set flag stays set until the add. */
+        if (((posted & ((uint32_t)1U << floor)) != 0U) &&
+            ((__atomic_load_n(&queue->generation[floor], __ATOMIC_ACQUIRE) & POSTED_FLAG) != 0U))
+        {
+            (void)__atomic_fetch_add(&queue->generation[floor], DRAIN_STEP, __ATOMIC_ACQ_REL);
+            taken |= (uint32_t)1U << floor;
+        }
+    }
+
+    return taken;
+}
+
+/**
+ * @brief Acknowledges the service of a floor.
+ *
+ * Serves the calls of the floor taken over by the drains so far. Only the control loop moves the
+ * generation on, so the word read here is the one of its last drain.
+ *
+ * @param[in,out] queue  Queue of the call.
+ * @param[in]     floor  Served floor.
+ */
+CALLQ_API void CallQ_ack(CallQ *queue, const uint8_t floor)
+{
+    if (floor < CALLQ_MAX_FLOORS)
+    {
+        uint32_t generation = __atomic_load_n(&queue->generation[floor], __ATOMIC_RELAXED) & ~POSTED_FLAG;
+        __atomic_store_n(&queue->served[floor], generation, __ATOMIC_RELEASE);
+    }
+}
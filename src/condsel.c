@@ -1,5 +1,41 @@
 #include "condsel.h"
 #include "posdet.h"
+#include <stddef.h>
+
+/* Call bits of the packed sensor word. */
+#define SENSOR_CALLS  (CONDSEL_IN_BELOW | CONDSEL_IN_SAME | CONDSEL_IN_ABOVE)
+
+/* Sensor bits selected by the condition indices, and the position check gating them. */
+static const uint8_t SensorSelect[8] = {
+    SENSOR_CALLS, CONDSEL_IN_BELOW, CONDSEL_IN_SAME, CONDSEL_IN_ABOVE,
+    CONDSEL_IN_DOOR_CLOSED, CONDSEL_IN_DOOR_OPEN, 0U, 0U
+};
+static const uint8_t SensorGate[8] = {
+    CONDSEL_IN_ELEVATOR_POS_OK, CONDSEL_IN_ELEVATOR_POS_OK, CONDSEL_IN_ELEVATOR_POS_OK, CONDSEL_IN_ELEVATOR_POS_OK,
+    CONDSEL_IN_DOOR_POS_OK, CONDSEL_IN_DOOR_POS_OK, 0U, 0U
+};
+
+/**
+ * @brief Checks the elevator position with the instance or the global binding.
+ *
+ * @param[in] posdet  Position detector instance, NULL for the global binding.
+ * @return True if the position is okay.
+ */
+static inline bool elevator_position_ok(const PosDet_Ops *posdet)
+{
+    return (posdet == NULL) ? PosDet_is_elevator_position_ok() : posdet->is_elevator_position_ok(posdet->context);
+}
+
+/**
+ * @brief Checks the door position with the instance or the global binding.
+ *
+ * @param[in] posdet  Position detector instance, NULL for the global binding.
+ * @return True if the position is okay.
+ */
+static inline bool door_position_ok(const PosDet_Ops *posdet)
+{
+    return (posdet == NULL) ? PosDet_is_door_position_ok() : posdet->is_door_position_ok(posdet->context);
+}
 
 /**
  * @brief Calculates the result of the condition selectors.
@@ -10,29 +46,30 @@
  * @param[in] invert  If true, the final result is inverted.
  * @param[in] index   Index of the condition to select.
  * @param[in] values  Struct containing the current state of all conditions.
+ * @param[in] posdet  Position detector instance, NULL for the global binding.
  * @return The boolean result of the selected condition.
  */
-CONDSEL_API bool CondSel_calc(const bool invert, const uint8_t index, const CondSel_In values) {
+static inline bool select_condition(const bool invert, const uint8_t index, const CondSel_In values, const PosDet_Ops *posdet) {
     bool result = false;
 
     switch (index) {
         case 0U:
             /* Any call is pending. */
-            if (PosDet_is_elevator_position_ok())
+            if (elevator_position_ok(posdet))
             {
                 result = values.call_pending_below || values.call_pending_same || values.call_pending_above;
             }
             break;
         case 1U:
             /* A call is pending below the current floor. */
-            if (PosDet_is_elevator_position_ok())
+            if (elevator_position_ok(posdet))
             {
                 result = values.call_pending_below;
             }
             break;
         case 2U:
             /* A call is pending on the current floor. */
-            if (PosDet_is_elevator_position_ok())
+            if (elevator_position_ok(posdet))
             {
                 result = values.call_pending_same;
             }
@@ -40,26 +77,27 @@ CONDSEL_API bool CondSel_calc(const bool invert, const uint8_t index, const Cond
             break;
         case 3U:
             /* A call is pending above the current floor. */
-            if (PosDet_is_elevator_position_ok())
+            if (elevator_position_ok(posdet))
             {
                 result = values.call_pending_above;
             }
             break;
         case 4U:
             /* The door is fully closed. */
-            if (PosDet_is_door_position_ok())
+            if (door_position_ok(posdet))
             {
                 result = values.door_closed;
             }
             break;
         case 5U:
             /* The door is fully open. */
-            if (PosDet_is_door_position_ok())
+            if (door_position_ok(posdet))
             {
                 result = values.door_open;
             }
             break;
-        case 6U:
+        case CONDSEL_INDEX_DISPATCH:
+            /* The packed vector has no boolean value. */
         case 7U:
             /* Always inactive. */
             result = false;
@@ -77,3 +115,170 @@ CONDSEL_API bool CondSel_calc(const bool invert, const uint8_t index, const Cond
 
     return result;
 }
+
+/**
+ * @brief Calculates the packed condition vector.
+ *
+ * The vector is the key of the multi-way dispatch instructions. The position checks gate
+ * the bits the same way as they gate the single conditions in CondSel_calc().
+ *
+ * @param[in] values  Struct containing the current state of all conditions.
+ * @param[in] posdet  Position detector instance, NULL for the global binding.
+ * @return The packed condition vector.
+ */
+static inline uint8_t pack_vector(const CondSel_In values, const PosDet_Ops *posdet) {
+    uint8_t vector = 0U;
+
+    if (elevator_position_ok(posdet))
+    {
+        vector |= values.call_pending_below ? CONDSEL_VEC_BELOW : 0U;
+        vector |= values.call_pending_same ? CONDSEL_VEC_SAME : 0U;
+        vector |= values.call_pending_above ? CONDSEL_VEC_ABOVE : 0U;
+    }
+
+    if (door_position_ok(posdet))
+    {
+        vector |= values.door_closed ? CONDSEL_VEC_DOOR_CLOSED : 0U;
+    }
+
+    return vector;
+}
+
+/**
+ * @brief Calculates the condition value of an instruction.
+ *
+ * @param[in] invert  If true, the boolean result is inverted.
+ * @param[in] index   Index of the condition to select.
+ * @param[in] values  Struct containing the current state of all conditions.
+ * @param[in] posdet  Position detector instance, NULL for the global binding.
+ * @return The packed condition vector for dispatch instructions, the boolean result otherwise.
+ */
+static inline uint8_t eval_condition(const bool invert, const uint8_t index, const CondSel_In values, const PosDet_Ops *posdet) {
+    if (index == CONDSEL_INDEX_DISPATCH)
+    {
+        return pack_vector(values, posdet);
+    }
+
+    return select_condition(invert, index, values, posdet) ? 1U : 0U;
+}
+
+/**
+ * @brief Calculates the result of the condition selectors with the global PosDet binding.
+ *
+ * @param[in] invert  If true, the final result is inverted.
+ * @param[in] index   Index of the condition to select.
+ * @param[in] values  Struct containing the current state of all conditions.
+ * @return The boolean result of the selected condition.
+ */
+CONDSEL_API bool CondSel_calc(const bool invert, const uint8_t index, const CondSel_In values) {
+    return select_condition(invert, index, values, NULL);
+}
+
+/**
+ * @brief Calculates the packed condition vector with the global PosDet binding.
+ *
+ * @param[in] values  Struct containing the current state of all conditions.
+ * @return The packed condition vector.
+ */
+CONDSEL_API uint8_t CondSel_vector(const CondSel_In values) {
+    return pack_vector(values, NULL);
+}
+
+/**
+ * @brief Calculates the condition value of an instruction with the global PosDet binding.
+ *
+ * @param[in] invert  If true, the boolean result is inverted.
+ * @param[in] index   Index of the condition to select.
+ * @param[in] values  Struct containing the current state of all conditions.
+ * @return The packed condition vector for dispatch instructions, the boolean result otherwise.
+ */
+CONDSEL_API uint8_t CondSel_eval(const bool invert, const uint8_t index, const CondSel_In values) {
+    return eval_condition(invert, index, values, NULL);
+}
+
+/**
+ * @brief Calculates the result of the condition selectors with a PosDet instance.
+ *
+ * @param[in] posdet  Position detector of the car.
+ * @param[in] invert  If true, the final result is inverted.
+ * @param[in] index   Index of the condition to select.
+ * @param[in] values  Struct containing the current state of all conditions.
+ * @return The boolean result of the selected condition.
+ */
+CONDSEL_API bool CondSel_calc_ops(const PosDet_Ops *posdet, const bool invert, const uint8_t index, const CondSel_In values) {
+    return select_condition(invert, index, values, posdet);
+}
+
+/**
+ * @brief Calculates the packed condition vector with a PosDet instance.
+ *
+ * @param[in] posdet  Position detector of the car.
+ * @param[in] values  Struct containing the current state of all conditions.
+ * @return The packed condition vector.
+ */
+CONDSEL_API uint8_t CondSel_vector_ops(const PosDet_Ops *posdet, const CondSel_In values) {
+    return pack_vector(values, posdet);
+}
+
+/**
+ * @brief Calculates the condition value of an instruction with a PosDet instance.
+ *
+ * @param[in] posdet  Position detector of the car.
+ * @param[in] invert  If true, the boolean result is inverted.
+ * @param[in] index   Index of the condition to select.
+ * @param[in] values  Struct containing the current state of all conditions.
+ * @return The packed condition vector for dispatch instructions, the boolean result otherwise.
+ */
+CONDSEL_API uint8_t CondSel_eval_ops(const PosDet_Ops *posdet, const bool invert, const uint8_t index, const CondSel_In values) {
+    return eval_condition(invert, index, values, posdet);
+}
+
+/**
+ * @brief Packs the inputs of a cycle into a sensor word.
+ *
+ * @param[in] values                Struct containing the current state of all conditions.
+ * @param[in] elevator_position_ok  Result of the elevator position check.
+ * @param[in] door_position_ok      Result of the door position check.
+ * @return The packed sensor word.
+ */
+CONDSEL_API uint8_t CondSel_pack(const CondSel_In values, const bool elevator_position_ok, const bool door_position_ok) {
+    uint8_t sensors = 0U;
+
+    sensors |= values.call_pending_below ? CONDSEL_IN_BELOW : 0U;
+    sensors |= values.call_pending_same ? CONDSEL_IN_SAME : 0U;
+    sensors |= values.call_pending_above ? CONDSEL_IN_ABOVE : 0U;
+    sensors |= values.door_closed ? CONDSEL_IN_DOOR_CLOSED : 0U;
+    sensors |= values.door_open ? CONDSEL_IN_DOOR_OPEN : 0U;
+    sensors |= elevator_position_ok ? CONDSEL_IN_ELEVATOR_POS_OK : 0U;
+    sensors |= door_position_ok ? CONDSEL_IN_DOOR_POS_OK : 0U;
+
+    return sensors;
+}
+
+/**
+ * @brief Calculates the condition value of an instruction from a packed sensor word.
+ *
+ * Table driven, without branches on the sensor values: a condition is active if any of its
+ * selected bits and its gating position check bit are set.
+ *
+ * @param[in] invert   If true, the boolean result is inverted.
+ * @param[in] index    Index of the condition to select.
+ * @param[in] sensors  Packed sensor word.
+ * @return The packed condition vector for dispatch instructions, the boolean result otherwise.
+ */
+CONDSEL_API uint8_t CondSel_eval_packed(const bool invert, const uint8_t index, const uint8_t sensors) {
+    if (index == CONDSEL_INDEX_DISPATCH)
+    {
+        uint8_t calls = ((sensors & CONDSEL_IN_ELEVATOR_POS_OK) != 0U) ? (uint8_t)(sensors & SENSOR_CALLS) : 0U;
+        uint8_t door = ((sensors & CONDSEL_IN_DOOR_POS_OK) != 0U) ? (uint8_t)(sensors & CONDSEL_IN_DOOR_CLOSED) : 0U;
+        return (uint8_t)(calls | door);
+    }
+
+    bool result = false;
+    if (index < 8U)
+    {
+        result = ((sensors & SensorSelect[index]) != 0U) && ((sensors & SensorGate[index]) != 0U);
+    }
+
+    return (result != invert) ? 1U : 0U;
+}
@@ -0,0 +1,30 @@
+#include "controller.h"
+#include "condsel.h"
+
+/**
+ * @brief Returns a controller to its power-up state.
+ *
+ * @param[out] controller  Controller to initialize.
+ */
+CONTROLLER_API void Controller_init(Controller *controller)
+{
+    SeqNet_init_state(&controller->state);
+    controller->instruction = SEQNET_POWER_UP_INSTRUCTION;
+}
+
+/**
+ * @brief Steps the controller by one cycle.
+ *
+ * @param[in,out] controller  Controller to step.
+ * @param[in]     sensors     Packed sensor word of the cycle.
+ * @return The new instruction word.
+ */
+CONTROLLER_API uint16_t Controller_step(Controller *controller, const uint8_t sensors)
+{
+    uint16_t previous = controller->instruction;
+    uint8_t condition = CondSel_eval_packed(SEQNET_COND_INV(previous), SEQNET_COND_SEL(previous), sensors);
+    uint16_t instruction = SeqNet_step_raw(&controller->state, condition);
+
+    controller->instruction = instruction;
+    return instruction;
+}
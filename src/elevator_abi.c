@@ -0,0 +1,139 @@
+#include "elevator_abi.h"
+#include "controller.h"
+#include <stdlib.h>
+
+/* The output bits of the ABI are fields of the instruction word, the header does not include seqnet.h. */
+_Static_assert(ELEV_OUT_JUMP_ADDR == SEQNET_FIELD_JUMP_ADDR, "ELEV_OUT_JUMP_ADDR must match seqnet.h");
+_Static_assert(ELEV_OUT_MOVE_UP == SEQNET_FIELD_MOVE_UP, "ELEV_OUT_MOVE_UP must match seqnet.h");
+_Static_assert(ELEV_OUT_MOVE_DOWN == SEQNET_FIELD_MOVE_DOWN, "ELEV_OUT_MOVE_DOWN must match seqnet.h");
+_Static_assert(ELEV_OUT_DOOR_OPEN == SEQNET_FIELD_DOOR_OPEN, "ELEV_OUT_DOOR_OPEN must match seqnet.h");
+_Static_assert(ELEV_OUT_RESET_CALL == SEQNET_FIELD_RESET, "ELEV_OUT_RESET_CALL must match seqnet.h");
+
+/** Batch of controllers. */
+struct ElevBatch {
+    uint32_t count;          /* Number of controllers */
+    Controller *controllers; /* Program counter and previous instruction word per controller */
+};
+
+/**
+ * @brief Reads the version of the library.
+ *
+ * @return (major << 16) | minor.
+ */
+ELEV_API uint32_t elev_abi_version(void)
+{
+    return (ELEV_ABI_VERSION_MAJOR << 16) | ELEV_ABI_VERSION_MINOR;
+}
+
+/**
+ * @brief Allocates a batch of controllers.
+ *
+ * @param[in] count  Number of controllers.
+ * @return Handle of the batch, NULL on failure.
+ */
+ELEV_API ElevBatch *elev_batch_create(uint32_t count)
+{
+    if (count == 0U)
+    {
+        return NULL;
+    }
+
+    ElevBatch *batch = (ElevBatch *)malloc(sizeof(*batch));
+    if (batch == NULL)
+    {
+        return NULL;
+    }
+
+    batch->count = count;
+    batch->controllers = (Controller *)malloc((size_t)count * sizeof(*batch->controllers));
+    if (batch->controllers == NULL)
+    {
+        elev_batch_destroy(batch);
+        return NULL;
+    }
+
+    (void)elev_batch_reset(batch);
+    return batch;
+}
+
+/**
+ * @brief Frees a batch.
+ *
+ * @param[in] batch  Handle of the batch.
+ */
+ELEV_API void elev_batch_destroy(ElevBatch *batch)
+{
+    if (batch != NULL)
+    {
+        free(batch->controllers);
+        free(batch);
+    }
+}
+
+/**
+ * @brief Reads the number of controllers.
+ *
+ * @param[in] batch  Handle of the batch.
+ * @return Number of controllers.
+ */
+ELEV_API uint32_t elev_batch_count(const ElevBatch *batch)
+{
+    return (batch != NULL) ? batch->count : 0U;
+}
+
+/**
+ * @brief Returns all controllers to their power-up state.
+ *
+ * @param[in] batch  Handle of the batch.
+ * @return ELEV_OK or ELEV_ERR_INVALID.
+ */
+ELEV_API int elev_batch_reset(ElevBatch *batch)
+{
+    if (batch == NULL)
+    {
+        return ELEV_ERR_INVALID;
+    }
+
+    for (uint32_t car = 0U; car < batch->count; car++)
+    {
+        Controller_init(&batch->controllers[car]);
+    }
+
+    return ELEV_OK;
+}
+
+/**
+ * @brief Steps every controller of the batch.
+ *
+ * Per car and cycle: the condition of the previous instruction is evaluated on the new sensor
+ * word, the controller is stepped with it and the new instruction word is written to the output.
+ *
+ * @param[in]  batch    Handle of the batch.
+ * @param[in]  sensors  Packed sensor words, cycle-major.
+ * @param[out] outputs  Instruction words, cycle-major.
+ * @param[in]  cycles   Number of cycles.
+ * @return ELEV_OK or ELEV_ERR_INVALID.
+ */
+ELEV_API int elev_batch_step(ElevBatch *batch, const uint8_t *sensors, uint16_t *outputs, uint32_t cycles)
+{
+    if ((batch == NULL) || (((sensors == NULL) || (outputs == NULL)) && (cycles != 0U)))
+    {
+        return ELEV_ERR_INVALID;
+    }
+
+    const uint32_t count = batch->count;
+    Controller *controllers = batch->controllers;
+
+    for (uint32_t cycle = 0U; cycle < cycles; cycle++)
+    {
+        const uint8_t *cycle_sensors = sensors + ((size_t)cycle * count);
+        uint16_t *cycle_outputs = outputs + ((size_t)cycle * count);
+
+        for (uint32_t car = 0U; car < count; car++)
+        {
+            cycle_outputs[car] = Controller_step(&controllers[car], cycle_sensors[car]);
+        }
+    }
+
+    return ELEV_OK;
+}
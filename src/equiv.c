@@ -0,0 +1,424 @@
+#include "equiv.h"
+#include "condsel.h"
+#include "seqnet.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+
+/* Product state key: PC of program a, PC of program b, power-up flag. */
+#define KEY_PC_B_SHIFT    8U
+#define KEY_POWER_UP      (1UL << 16)
+#define KEY_COUNT         (1UL << 17)
+
+/* Hash set of the visited keys, at most half full. Slots store key + 1, 0 is empty. */
+#define SET_BITS          18U
+#define SET_SIZE          (1UL << SET_BITS)
+#define SET_MASK          (SET_SIZE - 1U)
+#define SET_EMPTY         0U
+
+/* Parent link: parent key << 8 | sensor word. The root has no parent. */
+#define PARENT_NONE       UINT32_MAX
+#define PARENT_INPUT_MASK 0xFFU
+
+/* Number of frontier states a worker takes at once. */
+#define CHUNK_SIZE        64U
+
+/** Visited product states with their parent links. */
+typedef struct {
+    uint32_t *keys;
+    uint32_t *parents;
+} StateSet;
+
+/** Difference found while expanding a level. */
+typedef struct {
+    bool found;
+    uint32_t parent;         /* Key of the state the difference is reached from */
+    uint8_t sensors;         /* Input that shows the difference */
+} Mismatch;
+
+/** Shared state of the workers of one level. */
+typedef struct {
+    const uint16_t *a;
+    const uint16_t *b;
+    uint8_t stretch;
+    StateSet *set;
+    const uint32_t *frontier;
+    uint32_t frontier_size;
+    uint32_t next_chunk;     /* Atomic, next frontier index to take */
+    uint32_t *next;
+    uint32_t next_size;      /* Atomic, number of states in the next frontier */
+} Level;
+
+/** Work of one thread. */
+typedef struct {
+    Level *level;
+    Mismatch mismatch;
+} Worker;
+
+/**
+ * @brief Mixes a key into a slot index.
+ *
+ * @param[in] key  Product state key.
+ * @return Home slot of the key.
+ */
+static inline uint32_t slot_of(const uint32_t key)
+{
+    return (uint32_t)((key * 2654435761U) >> (32U - SET_BITS));
+}
+
+/**
+ * @brief Inserts a key into the set, lock-free.
+ *
+ * @param[in,out] set     Set of the visited states.
+ * @param[in]     key     Key to insert.
+ * @param[in]     parent  Parent link of the key, stored if the key is new.
+ * @return True if the key was not in the set yet.
+ */
+static bool set_insert(StateSet *set, const uint32_t key, const uint32_t parent)
+{
+    uint32_t slot = slot_of(key);
+
+    for (;;)
+    {
+        uint32_t expected = SET_EMPTY;
+        if (__atomic_compare_exchange_n(&set->keys[slot], &expected, key + 1U, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        {
+            set->parents[slot] = parent;
+            return true;
+        }
+
+        if (expected == (key + 1U))
+        {
+            return false;
+        }
+
+        slot = (slot + 1U) & SET_MASK;
+    }
+}
+
+/**
+ * @brief Looks up the parent link of a key, only called between levels.
+ *
+ * @param[in] set  Set of the visited states.
+ * @param[in] key  Key in the set.
+ * @return Parent link of the key.
+ */
+static uint32_t set_parent(const StateSet *set, const uint32_t key)
+{
+    uint32_t slot = slot_of(key);
+
+    while (set->keys[slot] != (key + 1U))
+    {
+        slot = (slot + 1U) & SET_MASK;
+    }
+
+    return set->parents[slot];
+}
+
+/**
+ * @brief Initializes a machine to power-up.
+ *
+ * @param[out] machine  Machine to initialize.
+ */
+EQUIV_API void Equiv_init(Equiv_Machine *machine)
+{
+    machine->pc = 0U;
+    machine->power_up = true;
+}
+
+/**
+ * @brief Steps a program by one cycle with the given sensor word.
+ *
+ * @param[in]     image    Program image.
+ * @param[in,out] machine  Position of the program.
+ * @param[in]     sensors  Packed sensor word.
+ * @return Requests of the new instruction.
+ */
+static uint8_t step_machine(const uint16_t *image, Equiv_Machine *machine, const uint8_t sensors)
+{
+    uint8_t condition = 0U;
+
+    if (!machine->power_up)
+    {
+        SeqNet_Out current = SeqNet_decode(image[machine->pc]);
+        condition = CondSel_eval_packed(current.cond_inv, current.cond_sel, sensors);
+    }
+
+    SeqNet_State state = {machine->pc};
+    uint16_t instruction = SeqNet_step_image(image, &state, condition);
+
+    machine->pc = state.pc;
+    machine->power_up = false;
+    return SEQNET_REQUESTS(instruction);
+}
+
+/**
+ * @brief Reacts to a sensor word, the way the checker steps a program.
+ *
+ * @param[in]     image    Program image.
+ * @param[in,out] machine  Position of the program.
+ * @param[in]     sensors  Packed sensor word, held during the reaction.
+ * @param[in]     stretch  0: one cycle, otherwise the reaction window.
+ * @param[out]    output   Requests after the reaction.
+ * @return Cycles until the requests changed, 0 if they did not change within the window.
+ */
+EQUIV_API uint8_t Equiv_react(const uint16_t *image, Equiv_Machine *machine, const uint8_t sensors,
+                              const uint8_t stretch, uint8_t *output)
+{
+    if (stretch == 0U)
+    {
+        *output = step_machine(image, machine, sensors);
+        return 1U;
+    }
+
+    uint8_t previous = machine->power_up ? 0U : SEQNET_REQUESTS(image[machine->pc]);
+
+    for (uint8_t cycle = 1U; cycle <= stretch; cycle++)
+    {
+        *output = step_machine(image, machine, sensors);
+        if (*output != previous)
+        {
+            return cycle;
+        }
+    }
+
+    return 0U;
+}
+
+/**
+ * @brief Expands the product state of a key with one input.
+ *
+ * @param[in]  level    Shared state of the level.
+ * @param[in]  key      Product state key.
+ * @param[in]  sensors  Input.
+ * @param[out] next     Key of the successor.
+ * @return True if the programs behave the same.
+ */
+static bool expand(const Level *level, const uint32_t key, const uint8_t sensors, uint32_t *next)
+{
+    bool power_up = ((key & KEY_POWER_UP) != 0U);
+    Equiv_Machine a = {(uint8_t)key, power_up};
+    Equiv_Machine b = {(uint8_t)(key >> KEY_PC_B_SHIFT), power_up};
+    uint8_t output_a;
+    uint8_t output_b;
+
+    uint8_t cycles_a = Equiv_react(level->a, &a, sensors, level->stretch, &output_a);
+    uint8_t cycles_b = Equiv_react(level->b, &b, sensors, level->stretch, &output_b);
+
+    *next = (uint32_t)a.pc | ((uint32_t)b.pc << KEY_PC_B_SHIFT);
+    return (output_a == output_b) && ((cycles_a == 0U) == (cycles_b == 0U));
+}
+
+/**
+ * @brief Expands chunks of the frontier until it is used up.
+ *
+ * Of the differences found, the one with the smallest parent key and input is kept, so the
+ * counterexample does not depend on the scheduling of the threads.
+ *
+ * @param[in,out] arg  Worker.
+ * @return NULL.
+ */
+static void *run_worker(void *arg)
+{
+    Worker *worker = arg;
+    Level *level = worker->level;
+
+    for (;;)
+    {
+        uint32_t begin = __atomic_fetch_add(&level->next_chunk, CHUNK_SIZE, __ATOMIC_RELAXED);
+        if (begin >= level->frontier_size)
+        {
+            break;
+        }
+
+        uint32_t end = (begin + CHUNK_SIZE < level->frontier_size) ? (begin + CHUNK_SIZE) : level->frontier_size;
+
+        for (uint32_t i = begin; i < end; i++)
+        {
+            uint32_t key = level->frontier[i];
+
+            for (uint32_t sensors = 0U; sensors < EQUIV_SENSOR_WORDS; sensors++)
+            {
+                uint32_t next;
+                if (!expand(level, key, (uint8_t)sensors, &next))
+                {
+                    Mismatch *mismatch = &worker->mismatch;
+                    if (!mismatch->found || (key < mismatch->parent) ||
+                        ((key == mismatch->parent) && (sensors < mismatch->sensors)))
+                    {
+                        mismatch->found = true;
+                        mismatch->parent = key;
+                        mismatch->sensors = (uint8_t)sensors;
+                    }
+                    continue;
+                }
+
+                if (set_insert(level->set, next, (key << 8) | sensors))
+                {
+                    uint32_t index = __atomic_fetch_add(&level->next_size, 1U, __ATOMIC_RELAXED);
+                    level->next[index] = next;
+                }
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Builds the counterexample from the parent links.
+ *
+ * @param[in]  set       Set of the visited states.
+ * @param[in]  mismatch  Difference found.
+ * @param[out] result    Receives the trace.
+ * @return 0 on success, -ENOMEM if the allocation failed.
+ */
+static int build_trace(const StateSet *set, const Mismatch *mismatch, Equiv_Result *result)
+{
+    uint32_t length = 1U;
+    for (uint32_t link = set_parent(set, mismatch->parent); link != PARENT_NONE; link = set_parent(set, link >> 8))
+    {
+        length++;
+    }
+
+    result->trace = malloc(length);
+    if (result->trace == NULL)
+    {
+        return -ENOMEM;
+    }
+
+    result->length = length;
+    result->trace[length - 1U] = mismatch->sensors;
+
+    uint32_t index = length - 1U;
+    for (uint32_t link = set_parent(set, mismatch->parent); link != PARENT_NONE; link = set_parent(set, link >> 8))
+    {
+        result->trace[--index] = (uint8_t)(link & PARENT_INPUT_MASK);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Checks the equivalence of two program images.
+ *
+ * Level-synchronous breadth first search over the product automaton, the levels are expanded by
+ * the worker threads. The search stops at the first level with a difference, so the trace is a
+ * shortest one.
+ *
+ * @param[in]  a       First program image.
+ * @param[in]  b       Second program image.
+ * @param[in]  config  Parameters of the check.
+ * @param[out] result  Verdict and counterexample.
+ * @return 0 on success, -EINVAL on invalid parameters, -ENOMEM if an allocation failed,
+ *         or the negative error of pthread_create.
+ */
+EQUIV_API int Equiv_check(const uint16_t *a, const uint16_t *b, const Equiv_Config *config, Equiv_Result *result)
+{
+    if ((a == NULL) || (b == NULL) || (config == NULL) || (result == NULL) || (config->threads > EQUIV_MAX_THREADS))
+    {
+        return -EINVAL;
+    }
+
+    result->equivalent = false;
+    result->states = 0U;
+    result->length = 0U;
+    result->trace = NULL;
+
+    StateSet set = {calloc(SET_SIZE, sizeof(uint32_t)), calloc(SET_SIZE, sizeof(uint32_t))};
+    uint32_t *frontier = malloc(KEY_COUNT * sizeof(uint32_t));
+    uint32_t *next = malloc(KEY_COUNT * sizeof(uint32_t));
+    int error = 0;
+
+    if ((set.keys == NULL) || (set.parents == NULL) || (frontier == NULL) || (next == NULL))
+    {
+        error = -ENOMEM;
+    }
+
+    uint32_t threads = (config->threads == 0U) ? 1U : config->threads;
+    uint32_t frontier_size = 1U;
+    Mismatch mismatch = {false, 0U, 0U};
+
+    if (error == 0)
+    {
+        frontier[0] = KEY_POWER_UP;
+        (void)set_insert(&set, KEY_POWER_UP, PARENT_NONE);
+        result->states = 1U;
+    }
+
+    while ((error == 0) && (frontier_size > 0U) && !mismatch.found)
+    {
+        Level level = {a, b, config->stretch, &set, frontier, frontier_size, 0U, next, 0U};
+        Worker workers[EQUIV_MAX_THREADS];
+        pthread_t ids[EQUIV_MAX_THREADS];
+        uint32_t started = 0U;
+
+        for (uint32_t t = 0U; t < threads; t++)
+        {
+            workers[t].level = &level;
+            workers[t].mismatch.found = false;
+        }
+
+        /* The calling thread is worker 0. */
+        for (uint32_t t = 1U; t < threads; t++)
+        {
+            int status = pthread_create(&ids[t], NULL, run_worker, &workers[t]);
+            if (status != 0)
+            {
+                error = -status;
+                break;
+            }
+            started = t;
+        }
+
+        (void)run_worker(&workers[0]);
+
+        for (uint32_t t = 1U; t <= started; t++)
+        {
+            (void)pthread_join(ids[t], NULL);
+        }
+
+        for (uint32_t t = 0U; t < threads; t++)
+        {
+            const Mismatch *found = &workers[t].mismatch;
+            if (found->found && (!mismatch.found || (found->parent < mismatch.parent) ||
+                                 ((found->parent == mismatch.parent) && (found->sensors < mismatch.sensors))))
+            {
+                mismatch = *found;
+            }
+        }
+
+        result->states += level.next_size;
+        frontier_size = level.next_size;
+
+        uint32_t *swap = frontier;
+        frontier = next;
+        next = swap;
+    }
+
+    if ((error == 0) && mismatch.found)
+    {
+        error = build_trace(&set, &mismatch, result);
+    }
+
+    result->equivalent = (error == 0) && !mismatch.found;
+
+    free(next);
+    free(frontier);
+    free(set.parents);
+    free(set.keys);
+    return error;
+}
+
+/**
+ * @brief Frees the counterexample of a result.
+ *
+ * @param[in,out] result  Result of Equiv_check().
+ */
+EQUIV_API void Equiv_free(Equiv_Result *result)
+{
+    free(result->trace);
+    result->trace = NULL;
+    result->length = 0U;
+}
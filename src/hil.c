@@ -0,0 +1,965 @@
+#include "hil.h"
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include "elevator_abi.h"
+
+/* Sensor words are 7 bits wide (@see CondSel_pack). */
+#define SENSOR_MASK      0x7FU
+
+/* Size of a frame on the wire. */
+#define FRAME_SIZE(count)  (HIL_FRAME_HEADER_SIZE + ((size_t)(count) * sizeof(uint16_t)))
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL     0
+#endif
+
+#define HIL_MAGIC        0x4C494845U  /* "EHIL" */
+
+/* Ring indices and flags are placed on separate cache lines, so producer and consumer do not
+ * invalidate each other's line on every frame. */
+#define CACHE_LINE_SIZE  64U
+
+/* Slots per ring. The protocol has at most one frame in flight per direction, the spare slots
+ * keep a sender from ever waiting for the receiver. */
+#define RING_SLOTS       4U
+
+/* Polls of a ring before the receiver goes to sleep, a few microseconds. A peer that answers
+ * right away is caught without the futex round trip, an idle rig does not occupy a CPU. On a
+ * single CPU the peer cannot answer while the receiver spins, it sleeps right away. */
+#define SPIN_LIMIT       256U
+
+/* Retry interval of the connecting peer while the endpoint does not exist yet. */
+#define RETRY_NS         1000000LL
+
+/* Shared memory header, the magic is written last by the server. */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t frame_size;
+    uint32_t connected;             /* Set by the peer, the server waits on it */
+    uint8_t pad[CACHE_LINE_SIZE - (4U * sizeof(uint32_t))];
+} ShmHeader;
+
+/* Single-producer single-consumer ring of frames. */
+typedef struct {
+    uint32_t head;                  /* Frames written by the producer, the consumer waits on it */
+    uint32_t closed;                /* The producer closed the link */
+    uint8_t pad0[CACHE_LINE_SIZE - (2U * sizeof(uint32_t))];
+    uint32_t tail;                  /* Frames taken by the consumer */
+    uint32_t waiting;               /* The consumer is about to sleep on head */
+    uint8_t pad1[CACHE_LINE_SIZE - (2U * sizeof(uint32_t))];
+    HIL_Frame slots[RING_SLOTS];
+} Ring;
+
+/* Ring 0 carries the frames of the peer, ring 1 the frames of the server. */
+typedef struct {
+    ShmHeader header;
+    Ring rings[2];
+} ShmSegment;
+
+/**
+ * @brief Reads the monotonic clock.
+ *
+ * @return Time in nanoseconds.
+ */
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((int64_t)ts.tv_sec * 1000000000LL) + (int64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Sleeps for a short interval.
+ *
+ * @param[in] ns  Interval in nanoseconds.
+ */
+static void sleep_ns(const int64_t ns)
+{
+    struct timespec ts = {(time_t)(ns / 1000000000LL), (long)(ns % 1000000000LL)};
+    (void)nanosleep(&ts, NULL);
+}
+
+/**
+ * @brief Reads the number of polls before a receiver sleeps.
+ *
+ * @return SPIN_LIMIT, 0 on a single CPU.
+ */
+static uint32_t spin_limit(void)
+{
+    static uint32_t limit = UINT32_MAX;
+
+    uint32_t value = __atomic_load_n(&limit, __ATOMIC_RELAXED);
+    if (value == UINT32_MAX)
+    {
+        value = (sysconf(_SC_NPROCESSORS_ONLN) > 1L) ? SPIN_LIMIT : 0U;
+        __atomic_store_n(&limit, value, __ATOMIC_RELAXED);
+    }
+    return value;
+}
+
+/**
+ * @brief Tells the CPU that the thread is spinning.
+ */
+static inline void cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+#if defined(__linux__)
+
+/**
+ * @brief Sleeps while a shared word holds a value, at most for the timeout.
+ *
+ * The futex is not process private, the word lives in shared memory.
+ *
+ * @param[in] word        Word to wait on.
+ * @param[in] value       Value the word is expected to hold.
+ * @param[in] timeout_ns  Timeout in nanoseconds.
+ */
+static void futex_wait(uint32_t *word, const uint32_t value, const int64_t timeout_ns)
+{
+    struct timespec ts = {(time_t)(timeout_ns / 1000000000LL), (long)(timeout_ns % 1000000000LL)};
+    (void)syscall(SYS_futex, word, FUTEX_WAIT, value, &ts, NULL, 0);
+}
+
+/**
+ * @brief Wakes all waiters of a shared word.
+ *
+ * @param[in] word  Word to wake.
+ */
+static void futex_wake(uint32_t *word)
+{
+    (void)syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+#else
+
+/**
+ * @brief Without futexes the waiter polls at a short interval.
+ */
+static void futex_wait(uint32_t *word, const uint32_t value, const int64_t timeout_ns)
+{
+    (void)word;
+    (void)value;
+    sleep_ns((timeout_ns < 50000LL) ? timeout_ns : 50000LL);
+}
+
+/**
+ * @brief Without futexes there is nothing to wake.
+ */
+static void futex_wake(uint32_t *word)
+{
+    (void)word;
+}
+
+#endif
+
+/**
+ * @brief Splits an address into its transport and name.
+ *
+ * @param[in]  address    "unix:PATH" or "shm:NAME".
+ * @param[out] transport  Receives the transport.
+ * @param[out] name       Receives the path or name.
+ * @return 0 on success, -EINVAL for an unknown transport, -ENAMETOOLONG if the name does not fit.
+ */
+static int parse_address(const char *address, HIL_Transport *transport, const char **name)
+{
+    if (strncmp(address, "unix:", 5U) == 0)
+    {
+        *transport = HIL_TRANSPORT_UNIX;
+        *name = address + 5U;
+        return (strlen(*name) < sizeof(((struct sockaddr_un *)NULL)->sun_path)) ? 0 : -ENAMETOOLONG;
+    }
+
+    if (strncmp(address, "shm:", 4U) == 0)
+    {
+        *transport = HIL_TRANSPORT_SHM;
+        *name = address + 4U;
+        return 0;
+    }
+
+    return -EINVAL;
+}
+
+/**
+ * @brief Initializes an unconnected link.
+ */
+static void init_link(HIL_Link *link, const HIL_Transport transport, const int timeout_ms)
+{
+    memset(link, 0, sizeof(*link));
+    link->transport = transport;
+    link->fd = -1;
+    link->timeout_ms = timeout_ms;
+}
+
+/**
+ * @brief Fills the address of a Unix domain socket, the length was checked by parse_address().
+ */
+static void socket_address(struct sockaddr_un *address, const char *path)
+{
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    memcpy(address->sun_path, path, strlen(path) + 1U);
+}
+
+/**
+ * @brief Creates a listening socket, accepts one peer and removes the socket file.
+ */
+static int serve_unix(HIL_Link *link, const char *path)
+{
+    struct sockaddr_un address;
+    socket_address(&address, path);
+
+    int listen_fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    if (listen_fd < 0)
+    {
+        return -errno;
+    }
+
+    /* Replace a stale socket file of a crashed rig. */
+    (void)unlink(path);
+    int result = 0;
+    if ((bind(listen_fd, (const struct sockaddr *)&address, sizeof(address)) != 0) || (listen(listen_fd, 1) != 0))
+    {
+        result = -errno;
+        (void)close(listen_fd);
+        (void)unlink(path);
+        return result;
+    }
+
+    struct pollfd pfd = {listen_fd, POLLIN, 0};
+    int ready = poll(&pfd, 1U, link->timeout_ms);
+    if (ready > 0)
+    {
+        link->fd = accept(listen_fd, NULL, NULL);
+        result = (link->fd < 0) ? -errno : 0;
+    }
+    else
+    {
+        result = (ready == 0) ? -ETIMEDOUT : -errno;
+    }
+
+    (void)close(listen_fd);
+    (void)unlink(path);
+    return result;
+}
+
+/**
+ * @brief Connects to a listening socket, retrying while it does not exist yet.
+ */
+static int connect_unix(HIL_Link *link, const char *path)
+{
+    struct sockaddr_un address;
+    socket_address(&address, path);
+    int64_t deadline = now_ns() + ((int64_t)link->timeout_ms * 1000000LL);
+
+    for (;;)
+    {
+        int fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+        if (fd < 0)
+        {
+            return -errno;
+        }
+
+        if (connect(fd, (const struct sockaddr *)&address, sizeof(address)) == 0)
+        {
+            link->fd = fd;
+            return 0;
+        }
+
+        int result = -errno;
+        (void)close(fd);
+        if ((result != -ENOENT) && (result != -ECONNREFUSED))
+        {
+            return result;
+        }
+        if (now_ns() >= deadline)
+        {
+            return -ETIMEDOUT;
+        }
+        sleep_ns(RETRY_NS);
+    }
+}
+
+/**
+ * @brief Points the rings of a link at a mapped segment.
+ */
+static void attach_rings(HIL_Link *link, void *base, const size_t size, const bool server)
+{
+    ShmSegment *segment = (ShmSegment *)base;
+
+    link->base = base;
+    link->size = size;
+    link->rx = &segment->rings[server ? 0U : 1U];
+    link->tx = &segment->rings[server ? 1U : 0U];
+}
+
+/**
+ * @brief Creates the shared memory segment, waits for the peer and removes the name.
+ */
+static int serve_shm(HIL_Link *link, const char *name)
+{
+    const size_t size = sizeof(ShmSegment);
+
+    (void)shm_unlink(name);
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+    {
+        return -errno;
+    }
+
+    int result = 0;
+    if (ftruncate(fd, (off_t)size) != 0)
+    {
+        result = -errno;
+        (void)close(fd);
+        (void)shm_unlink(name);
+        return result;
+    }
+
+    void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    result = (base == MAP_FAILED) ? -errno : 0;
+    (void)close(fd);
+    if (result != 0)
+    {
+        (void)shm_unlink(name);
+        return result;
+    }
+
+    /* The rings are empty after ftruncate. The header is completed last. */
+    ShmSegment *segment = (ShmSegment *)base;
+    segment->header.version = HIL_VERSION;
+    segment->header.frame_size = (uint32_t)sizeof(HIL_Frame);
+    __atomic_store_n(&segment->header.magic, (uint32_t)HIL_MAGIC, __ATOMIC_RELEASE);
+
+    int64_t deadline = now_ns() + ((int64_t)link->timeout_ms * 1000000LL);
+    result = -ETIMEDOUT;
+    for (int64_t now = now_ns(); now < deadline; now = now_ns())
+    {
+        if (__atomic_load_n(&segment->header.connected, __ATOMIC_ACQUIRE) != 0U)
+        {
+            result = 0;
+            break;
+        }
+        futex_wait(&segment->header.connected, 0U, deadline - now);
+    }
+
+    (void)shm_unlink(name);
+    if (result != 0)
+    {
+        (void)munmap(base, size);
+        return result;
+    }
+
+    attach_rings(link, base, size, true);
+    return 0;
+}
+
+/**
+ * @brief Maps the segment of a server, retrying while it does not exist yet, and claims it.
+ */
+static int connect_shm(HIL_Link *link, const char *name)
+{
+    const size_t size = sizeof(ShmSegment);
+    int64_t deadline = now_ns() + ((int64_t)link->timeout_ms * 1000000LL);
+
+    for (;;)
+    {
+        int fd = shm_open(name, O_RDWR, 0);
+        if (fd >= 0)
+        {
+            struct stat st;
+            int result = (fstat(fd, &st) == 0) ? 0 : -errno;
+            void *base = MAP_FAILED;
+
+            /* The server may not have sized the segment yet. */
+            if ((result == 0) && ((size_t)st.st_size == size))
+            {
+                base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                result = (base == MAP_FAILED) ? -errno : 0;
+            }
+            (void)close(fd);
+            if (result != 0)
+            {
+                return result;
+            }
+
+            if (base != MAP_FAILED)
+            {
+                ShmSegment *segment = (ShmSegment *)base;
+                if (__atomic_load_n(&segment->header.magic, __ATOMIC_ACQUIRE) == HIL_MAGIC)
+                {
+                    uint32_t expected = 0U;
+                    if ((segment->header.version != HIL_VERSION) ||
+                        (segment->header.frame_size != sizeof(HIL_Frame)))
+                    {
+                        result = -EPROTO;
+                    }
+                    else if (!__atomic_compare_exchange_n(&segment->header.connected, &expected, 1U, false,
+                                                          __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+                    {
+                        result = -EBUSY;
+                    }
+                    else
+                    {
+                        futex_wake(&segment->header.connected);
+                        attach_rings(link, base, size, false);
+                        return 0;
+                    }
+
+                    (void)munmap(base, size);
+                    return result;
+                }
+                (void)munmap(base, size);
+            }
+        }
+        else if (errno != ENOENT)
+        {
+            return -errno;
+        }
+
+        if (now_ns() >= deadline)
+        {
+            return -ETIMEDOUT;
+        }
+        sleep_ns(RETRY_NS);
+    }
+}
+
+/**
+ * @brief Creates the endpoint of an address and waits until the peer connected.
+ *
+ * @param[out] link        Link to initialize.
+ * @param[in]  address     "unix:PATH" or "shm:NAME".
+ * @param[in]  timeout_ms  Timeout of waiting for the peer and of receiving.
+ * @return 0 on success, negative errno value otherwise.
+ */
+HIL_API int HIL_serve(HIL_Link *link, const char *address, const int timeout_ms)
+{
+    HIL_Transport transport = HIL_TRANSPORT_UNIX;
+    const char *name = NULL;
+
+    init_link(link, transport, timeout_ms);
+    int result = parse_address(address, &transport, &name);
+    if (result != 0)
+    {
+        return result;
+    }
+
+    link->transport = transport;
+    return (transport == HIL_TRANSPORT_UNIX) ? serve_unix(link, name) : serve_shm(link, name);
+}
+
+/**
+ * @brief Connects to the endpoint of an address.
+ *
+ * @param[out] link        Link to initialize.
+ * @param[in]  address     "unix:PATH" or "shm:NAME".
+ * @param[in]  timeout_ms  Timeout of waiting for the endpoint and of receiving.
+ * @return 0 on success, negative errno value otherwise.
+ */
+HIL_API int HIL_connect(HIL_Link *link, const char *address, const int timeout_ms)
+{
+    HIL_Transport transport = HIL_TRANSPORT_UNIX;
+    const char *name = NULL;
+
+    init_link(link, transport, timeout_ms);
+    int result = parse_address(address, &transport, &name);
+    if (result != 0)
+    {
+        return result;
+    }
+
+    link->transport = transport;
+    return (transport == HIL_TRANSPORT_UNIX) ? connect_unix(link, name) : connect_shm(link, name);
+}
+
+/**
+ * @brief Closes the link.
+ *
+ * A shared memory link marks its sending ring closed and wakes the peer before it unmaps.
+ *
+ * @param[in,out] link  Link to close.
+ */
+HIL_API void HIL_close(HIL_Link *link)
+{
+    if (link->fd >= 0)
+    {
+        (void)close(link->fd);
+    }
+
+    if (link->base != NULL)
+    {
+        Ring *tx = (Ring *)link->tx;
+        __atomic_store_n(&tx->closed, 1U, __ATOMIC_SEQ_CST);
+        futex_wake(&tx->head);
+        (void)munmap(link->base, link->size);
+    }
+
+    link->fd = -1;
+    link->base = NULL;
+    link->rx = NULL;
+    link->tx = NULL;
+}
+
+/**
+ * @brief Writes a frame into the sending ring and wakes the receiver if it sleeps.
+ */
+static int ring_send(HIL_Link *link, const HIL_Frame *frame)
+{
+    Ring *ring = (Ring *)link->tx;
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    int64_t deadline = 0;
+
+    while ((head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE)) >= RING_SLOTS)
+    {
+        int64_t now = now_ns();
+        if (deadline == 0)
+        {
+            deadline = now + ((int64_t)link->timeout_ms * 1000000LL);
+        }
+        else if (now >= deadline)
+        {
+            return -ETIMEDOUT;
+        }
+        (void)sched_yield();
+    }
+
+    memcpy(&ring->slots[head % RING_SLOTS], frame, FRAME_SIZE(frame->count));
+
+    /* Pairs with the store of waiting in ring_receive(): either the receiver sees the new head,
+     * or the sender sees it waiting. */
+    __atomic_store_n(&ring->head, head + 1U, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->waiting, __ATOMIC_SEQ_CST) != 0U)
+    {
+        futex_wake(&ring->head);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Takes a frame from the receiving ring, spinning first and then sleeping on the head.
+ */
+static int ring_receive(HIL_Link *link, HIL_Frame *frame)
+{
+    Ring *ring = (Ring *)link->rx;
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    int64_t deadline = 0;
+    uint32_t spins = spin_limit();
+
+    while (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == tail)
+    {
+        if (__atomic_load_n(&ring->closed, __ATOMIC_ACQUIRE) != 0U)
+        {
+            return -EPIPE;
+        }
+
+        if (spins != 0U)
+        {
+            spins--;
+            cpu_relax();
+            continue;
+        }
+
+        int64_t now = now_ns();
+        if (deadline == 0)
+        {
+            deadline = now + ((int64_t)link->timeout_ms * 1000000LL);
+        }
+        else if (now >= deadline)
+        {
+            return -ETIMEDOUT;
+        }
+
+        __atomic_store_n(&ring->waiting, 1U, __ATOMIC_SEQ_CST);
+        if ((__atomic_load_n(&ring->head, __ATOMIC_SEQ_CST) == tail) &&
+            (__atomic_load_n(&ring->closed, __ATOMIC_SEQ_CST) == 0U))
+        {
+            futex_wait(&ring->head, tail, deadline - now);
+        }
+        __atomic_store_n(&ring->waiting, 0U, __ATOMIC_RELAXED);
+    }
+
+    /* The slot is owned by the receiver until the tail passes it. The count is checked before
+     * it sizes the copy, the segment is shared with another process. */
+    const HIL_Frame *slot = &ring->slots[tail % RING_SLOTS];
+    memcpy(frame, slot, HIL_FRAME_HEADER_SIZE);
+    int result = -EPROTO;
+    if (frame->count <= HIL_MAX_CARS)
+    {
+        memcpy(frame->words, slot->words, (size_t)frame->count * sizeof(uint16_t));
+        result = 0;
+    }
+
+    __atomic_store_n(&ring->tail, tail + 1U, __ATOMIC_RELEASE);
+    return result;
+}
+
+/**
+ * @brief Sends one frame as one message.
+ */
+static int socket_send(HIL_Link *link, const HIL_Frame *frame)
+{
+    ssize_t sent = send(link->fd, frame, FRAME_SIZE(frame->count), MSG_NOSIGNAL);
+    return (sent < 0) ? -errno : 0;
+}
+
+/**
+ * @brief Receives one message and checks that it is a complete frame.
+ */
+static int socket_receive(HIL_Link *link, HIL_Frame *frame)
+{
+    struct pollfd pfd = {link->fd, POLLIN, 0};
+    int ready;
+
+    do
+    {
+        ready = poll(&pfd, 1U, link->timeout_ms);
+    } while ((ready < 0) && (errno == EINTR));
+
+    if (ready <= 0)
+    {
+        return (ready == 0) ? -ETIMEDOUT : -errno;
+    }
+
+    ssize_t received = recv(link->fd, frame, sizeof(*frame), 0);
+    if (received <= 0)
+    {
+        return (received == 0) ? -EPIPE : -errno;
+    }
+
+    if (((size_t)received < HIL_FRAME_HEADER_SIZE) ||
+        (frame->count > HIL_MAX_CARS) ||
+        ((size_t)received != FRAME_SIZE(frame->count)))
+    {
+        return -EPROTO;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Sends a frame.
+ *
+ * @param[in,out] link   Link to send on.
+ * @param[in]     frame  Frame to send.
+ * @return 0 on success, negative errno value otherwise.
+ */
+HIL_API int HIL_send(HIL_Link *link, const HIL_Frame *frame)
+{
+    if (frame->count > HIL_MAX_CARS)
+    {
+        return -EINVAL;
+    }
+
+    if (link->base != NULL)
+    {
+        return ring_send(link, frame);
+    }
+
+    return (link->fd >= 0) ? socket_send(link, frame) : -ENOTCONN;
+}
+
+/**
+ * @brief Receives a frame.
+ *
+ * @param[in,out] link   Link to receive on.
+ * @param[out]    frame  Receives the frame.
+ * @return 0 on success, negative errno value otherwise.
+ */
+HIL_API int HIL_receive(HIL_Link *link, HIL_Frame *frame)
+{
+    if (link->base != NULL)
+    {
+        return ring_receive(link, frame);
+    }
+
+    return (link->fd >= 0) ? socket_receive(link, frame) : -ENOTCONN;
+}
+
+#else
+
+/**
+ * @brief Reads a clock for the round trips, the transports are not available anyway.
+ */
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    (void)timespec_get(&ts, TIME_UTC);
+    return ((int64_t)ts.tv_sec * 1000000000LL) + (int64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Sockets and shared memory are not available on this platform.
+ *
+ * @return -ENOSYS.
+ */
+HIL_API int HIL_serve(HIL_Link *link, const char *address, const int timeout_ms)
+{
+    (void)address;
+    memset(link, 0, sizeof(*link));
+    link->fd = -1;
+    link->timeout_ms = timeout_ms;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Sockets and shared memory are not available on this platform.
+ *
+ * @return -ENOSYS.
+ */
+HIL_API int HIL_connect(HIL_Link *link, const char *address, const int timeout_ms)
+{
+    return HIL_serve(link, address, timeout_ms);
+}
+
+/**
+ * @brief Nothing to close on this platform.
+ *
+ * @param[in,out] link  Link to close.
+ */
+HIL_API void HIL_close(HIL_Link *link)
+{
+    link->fd = -1;
+    link->base = NULL;
+}
+
+/**
+ * @brief Sockets and shared memory are not available on this platform.
+ *
+ * @return -ENOSYS.
+ */
+HIL_API int HIL_send(HIL_Link *link, const HIL_Frame *frame)
+{
+    (void)link;
+    (void)frame;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Sockets and shared memory are not available on this platform.
+ *
+ * @return -ENOSYS.
+ */
+HIL_API int HIL_receive(HIL_Link *link, HIL_Frame *frame)
+{
+    (void)link;
+    (void)frame;
+    return -ENOSYS;
+}
+
+#endif
+
+/**
+ * @brief Serves a session: acknowledges the peer and answers every sensor frame.
+ *
+ * The controllers of the cars are created with the session, all in their power-up state.
+ *
+ * @param[in,out] link   Connected link.
+ * @param[out]    stats  Receives the round trips from an actuator frame to the next sensor frame.
+ * @return 0 when the peer ended the session, negative errno value otherwise.
+ */
+HIL_API int HIL_run_gateway(HIL_Link *link, HIL_Stats *stats)
+{
+    HIL_Frame frame;
+    Histo_init(&stats->rtt);
+    stats->ticks = 0U;
+
+    int result = HIL_receive(link, &frame);
+    if (result != 0)
+    {
+        return result;
+    }
+    if ((frame.type != HIL_FRAME_HELLO) || (frame.tick != HIL_VERSION) ||
+        (frame.count == 0U) || (frame.count > HIL_MAX_CARS))
+    {
+        return -EPROTO;
+    }
+
+    const uint32_t cars = frame.count;
+    ElevBatch *batch = elev_batch_create(cars);
+    if (batch == NULL)
+    {
+        return -ENOMEM;
+    }
+
+    frame.type = HIL_FRAME_HELLO_ACK;
+    result = HIL_send(link, &frame);
+
+    uint8_t sensors[HIL_MAX_CARS];
+    int64_t sent = 0;
+    while (result == 0)
+    {
+        result = HIL_receive(link, &frame);
+        if (result != 0)
+        {
+            break;
+        }
+
+        if (frame.type == HIL_FRAME_BYE)
+        {
+            break;
+        }
+        if ((frame.type != HIL_FRAME_SENSORS) || (frame.tick != stats->ticks) || (frame.count != cars))
+        {
+            result = -EPROTO;
+            break;
+        }
+
+        if (sent != 0)
+        {
+            Histo_record(&stats->rtt, (uint64_t)(now_ns() - sent));
+        }
+
+        for (uint32_t car = 0U; car < cars; car++)
+        {
+            if (frame.words[car] > SENSOR_MASK)
+            {
+                result = -EPROTO;
+            }
+            sensors[car] = (uint8_t)frame.words[car];
+        }
+        if (result != 0)
+        {
+            break;
+        }
+
+        (void)elev_batch_step(batch, sensors, frame.words, 1U);
+        frame.type = HIL_FRAME_ACTUATORS;
+        sent = now_ns();
+        result = HIL_send(link, &frame);
+        stats->ticks++;
+    }
+
+    elev_batch_destroy(batch);
+    return result;
+}
+
+/**
+ * @brief Opens a session.
+ *
+ * @param[in,out] link   Connected link.
+ * @param[in]     cars   Number of cars.
+ * @param[out]    stats  Statistics of the session to initialize.
+ * @return 0 on success, negative errno value otherwise.
+ */
+HIL_API int HIL_hello(HIL_Link *link, const uint32_t cars, HIL_Stats *stats)
+{
+    HIL_Frame frame;
+
+    Histo_init(&stats->rtt);
+    stats->ticks = 0U;
+    if ((cars == 0U) || (cars > HIL_MAX_CARS))
+    {
+        return -EINVAL;
+    }
+
+    frame.type = HIL_FRAME_HELLO;
+    frame.count = cars;
+    frame.tick = HIL_VERSION;
+    memset(frame.words, 0, (size_t)cars * sizeof(uint16_t));
+
+    int result = HIL_send(link, &frame);
+    if (result == 0)
+    {
+        result = HIL_receive(link, &frame);
+    }
+    if ((result == 0) && ((frame.type != HIL_FRAME_HELLO_ACK) || (frame.count != cars)))
+    {
+        result = -EPROTO;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Exchanges the sensor words and the instruction words of one tick.
+ *
+ * @param[in,out] link     Link of the session.
+ * @param[in]     tick     Tick of the exchange.
+ * @param[in]     sensors  Packed sensor words.
+ * @param[out]    outputs  Receives the instruction words.
+ * @param[in]     cars     Number of cars of the session.
+ * @param[in,out] stats    Statistics of the session.
+ * @return 0 on success, negative errno value otherwise.
+ */
+HIL_API int HIL_exchange(HIL_Link *link, const uint64_t tick, const uint8_t *sensors, uint16_t *outputs,
+                         const uint32_t cars, HIL_Stats *stats)
+{
+    HIL_Frame frame;
+
+    if ((cars == 0U) || (cars > HIL_MAX_CARS))
+    {
+        return -EINVAL;
+    }
+
+    frame.type = HIL_FRAME_SENSORS;
+    frame.count = cars;
+    frame.tick = tick;
+    for (uint32_t car = 0U; car < cars; car++)
+    {
+        frame.words[car] = sensors[car];
+    }
+
+    int64_t start = now_ns();
+    int result = HIL_send(link, &frame);
+    if (result == 0)
+    {
+        result = HIL_receive(link, &frame);
+    }
+    if (result != 0)
+    {
+        return result;
+    }
+
+    Histo_record(&stats->rtt, (uint64_t)(now_ns() - start));
+    if ((frame.type != HIL_FRAME_ACTUATORS) || (frame.tick != tick) || (frame.count != cars))
+    {
+        return -EPROTO;
+    }
+
+    memcpy(outputs, frame.words, (size_t)cars * sizeof(uint16_t));
+    stats->ticks++;
+    return 0;
+}
+
+/**
+ * @brief Ends the session.
+ *
+ * @param[in,out] link  Link of the session.
+ * @return 0 on success, negative errno value otherwise.
+ */
+HIL_API int HIL_bye(HIL_Link *link)
+{
+    HIL_Frame frame;
+
+    frame.type = HIL_FRAME_BYE;
+    frame.count = 0U;
+    frame.tick = 0U;
+    return HIL_send(link, &frame);
+}
@@ -0,0 +1,201 @@
+#include "histo.h"
+
+/**
+ * @brief Clears the histogram.
+ *
+ * @param[out] histo  Histogram to clear.
+ */
+HISTO_API void Histo_init(Histo *histo)
+{
+    for (uint32_t i = 0U; i < HISTO_BUCKETS; i++)
+    {
+        histo->counts[i] = 0U;
+    }
+
+    histo->total = 0U;
+    histo->sum = 0U;
+    histo->min = UINT64_MAX;
+    histo->max = 0U;
+}
+
+/**
+ * @brief Calculates the bucket index of a value.
+ *
+ * Values below HISTO_SUB_BUCKETS map to themselves. Above that the position of the most
+ * significant bit selects the range and the next HISTO_SUB_BITS bits the sub-bucket.
+ *
+ * @param[in] value  Sample value.
+ * @return Index of the bucket.
+ */
+HISTO_API uint32_t Histo_bucket(const uint64_t value)
+{
+    if (value < HISTO_SUB_BUCKETS)
+    {
+        return (uint32_t)value;
+    }
+
+    uint32_t msb = 63U - (uint32_t)__builtin_clzll(value);
+    uint32_t shift = msb - HISTO_SUB_BITS;
+    uint32_t sub = (uint32_t)(value >> shift) & (HISTO_SUB_BUCKETS - 1U);
+
+    return ((shift + 1U) * HISTO_SUB_BUCKETS) + sub;
+}
+
+/**
+ * @brief Calculates the smallest value of a bucket.
+ *
+ * @param[in] bucket  Bucket index.
+ * @return Lower bound of the bucket.
+ */
+HISTO_API uint64_t Histo_bucket_low(const uint32_t bucket)
+{
+    if (bucket < HISTO_SUB_BUCKETS)
+    {
+        return bucket;
+    }
+
+    uint32_t shift = (bucket / HISTO_SUB_BUCKETS) - 1U;
+    uint64_t sub = bucket % HISTO_SUB_BUCKETS;
+
+    return (HISTO_SUB_BUCKETS + sub) << shift;
+}
+
+/**
+ * @brief Calculates the largest value of a bucket.
+ *
+ * @param[in] bucket  Bucket index.
+ * @return Upper bound (inclusive) of the bucket.
+ */
+HISTO_API uint64_t Histo_bucket_high(const uint32_t bucket)
+{
+    if (bucket < HISTO_SUB_BUCKETS)
+    {
+        return bucket;
+    }
+
+    uint32_t shift = (bucket / HISTO_SUB_BUCKETS) - 1U;
+
+    return Histo_bucket_low(bucket) + ((1ULL << shift) - 1U);
+}
+
+/**
+ * @brief Counts a sample.
+ *
+ * @param[in,out] histo  Histogram to update.
+ * @param[in]     value  Sample value.
+ */
+HISTO_API void Histo_record(Histo *histo, const uint64_t value)
+{
+    histo->counts[Histo_bucket(value)]++;
+    histo->total++;
+    histo->sum += value;
+
+    if (value < histo->min)
+    {
+        histo->min = value;
+    }
+    if (value > histo->max)
+    {
+        histo->max = value;
+    }
+}
+
+/**
+ * @brief Calculates a percentile.
+ *
+ * @param[in] histo       Histogram to evaluate.
+ * @param[in] percentile  Percentile in the range of 0..100.
+ * @return Upper bound of the bucket containing the percentile, at most the largest sample.
+ */
+HISTO_API uint64_t Histo_percentile(const Histo *histo, const double percentile)
+{
+    if (histo->total == 0U)
+    {
+        return 0U;
+    }
+
+    /* Rank of the sample, rounded up, at least the first one. */
+    double exact_rank = (percentile / 100.0) * (double)histo->total;
+    uint64_t rank = (uint64_t)exact_rank;
+    if ((double)rank < exact_rank)
+    {
+        rank++;
+    }
+    if (rank == 0U)
+    {
+        rank = 1U;
+    }
+
+    uint64_t seen = 0U;
+    for (uint32_t i = 0U; i < HISTO_BUCKETS; i++)
+    {
+        seen += histo->counts[i];
+        if (seen >= rank)
+        {
+            uint64_t high = Histo_bucket_high(i);
+            return (high < histo->max) ? high : histo->max;
+        }
+    }
+
+    return histo->max;
+}
+
+/**
+ * @brief Adds the samples of a histogram to another one.
+ *
+ * @param[in,out] histo  Histogram to add to.
+ * @param[in]     other  Histogram to add.
+ */
+HISTO_API void Histo_merge(Histo *histo, const Histo *other)
+{
+    for (uint32_t i = 0U; i < HISTO_BUCKETS; i++)
+    {
+        histo->counts[i] += other->counts[i];
+    }
+
+    histo->total += other->total;
+    histo->sum += other->sum;
+
+    if (other->min < histo->min)
+    {
+        histo->min = other->min;
+    }
+    if (other->max > histo->max)
+    {
+        histo->max = other->max;
+    }
+}
+
+/**
+ * @brief Writes a histogram as a JSON object.
+ *
+ * An empty histogram is written with min 0.
+ *
+ * @param[in] histo  Histogram to write.
+ * @param[in] file   Stream to write to.
+ */
+HISTO_API void Histo_write_json(const Histo *histo, FILE *file)
+{
+    fprintf(file, "{\"samples\": %llu, \"min\": %llu, \"p50\": %llu, \"p99\": %llu, \"p99.9\": %llu, \"max\": %llu, \"buckets\": [",
+            (unsigned long long)histo->total,
+            (unsigned long long)((histo->total != 0U) ? histo->min : 0U),
+            (unsigned long long)Histo_percentile(histo, 50.0),
+            (unsigned long long)Histo_percentile(histo, 99.0),
+            (unsigned long long)Histo_percentile(histo, 99.9),
+            (unsigned long long)histo->max);
+
+    const char *separator = "";
+    for (uint32_t i = 0U; i < HISTO_BUCKETS; i++)
+    {
+        if (histo->counts[i] != 0U)
+        {
+            fprintf(file, "%s[%llu, %llu, %llu]", separator,
+                    (unsigned long long)Histo_bucket_low(i),
+                    (unsigned long long)Histo_bucket_high(i),
+                    (unsigned long long)histo->counts[i]);
+            separator = ", ";
+        }
+    }
+
+    fprintf(file, "]}");
+}
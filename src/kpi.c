@@ -0,0 +1,310 @@
+#include "kpi.h"
+#include <errno.h>
+#include <stdlib.h>
+
+/* Start of a trip that was in progress at the first report. */
+#define TRIP_UNKNOWN  UINT64_MAX
+
+/**
+ * @brief Clears the histograms of a floor.
+ */
+static void init_histos(Kpi_Histos *histos)
+{
+    Histo_init(&histos->service);
+    Histo_init(&histos->dwell);
+    Histo_init(&histos->travel);
+}
+
+/**
+ * @brief Adds the histograms of a floor.
+ */
+static void merge_histos(Kpi_Histos *histos, const Kpi_Histos *other)
+{
+    Histo_merge(&histos->service, &other->service);
+    Histo_merge(&histos->dwell, &other->dwell);
+    Histo_merge(&histos->travel, &other->travel);
+}
+
+/**
+ * @brief Counts a sample in the histogram of a floor and in the one of all floors.
+ *
+ * @param[in,out] floor_histo  Histogram of the floor.
+ * @param[in,out] all_histo    Histogram of all floors.
+ * @param[in]     value        Sample in cycles.
+ */
+static void record(Histo *floor_histo, Histo *all_histo, const uint64_t value)
+{
+    Histo_record(floor_histo, value);
+    Histo_record(all_histo, value);
+}
+
+/**
+ * @brief Initializes the KPIs.
+ *
+ * @param[out] kpi     KPIs to initialize.
+ * @param[in]  floors  Number of floors, clamped to 1..KPI_MAX_FLOORS.
+ */
+KPI_API void Kpi_init(Kpi *kpi, const uint8_t floors)
+{
+    kpi->floors = (floors == 0U) ? 1U : ((floors > KPI_MAX_FLOORS) ? (uint8_t)KPI_MAX_FLOORS : floors);
+    kpi->cycle = 0U;
+
+    for (uint32_t k = 0U; k < KPI_MAX_FLOORS; k++)
+    {
+        kpi->call_cycle[k] = KPI_NO_CALL;
+        kpi->dropped[k] = 0U;
+        init_histos(&kpi->floor[k]);
+    }
+    init_histos(&kpi->all);
+
+    Kpi_restart(kpi);
+}
+
+/**
+ * @brief Forgets the state of the car and counts the pending calls as unserved.
+ *
+ * @param[in,out] kpi  KPIs to update.
+ */
+KPI_API void Kpi_restart(Kpi *kpi)
+{
+    for (uint32_t k = 0U; k < KPI_MAX_FLOORS; k++)
+    {
+        if (kpi->call_cycle[k] != KPI_NO_CALL)
+        {
+            kpi->dropped[k]++;
+            kpi->call_cycle[k] = KPI_NO_CALL;
+        }
+    }
+
+    kpi->known = false;
+    kpi->door_open = false;
+    kpi->door_since = 0U;
+    kpi->trip_since = 0U;
+}
+
+/**
+ * @brief Registers a call in the current cycle.
+ *
+ * @param[in,out] kpi    KPIs to update.
+ * @param[in]     floor  Floor of the call.
+ */
+KPI_API void Kpi_call(Kpi *kpi, const uint8_t floor)
+{
+    if ((floor < kpi->floors) && (kpi->call_cycle[floor] == KPI_NO_CALL))
+    {
+        kpi->call_cycle[floor] = kpi->cycle;
+    }
+}
+
+/**
+ * @brief Reports the state of the car after a cycle.
+ *
+ * A cycle completes the service of a call registered in an earlier one, so the service time is
+ * at least 1. A trip starts with the first cycle moving after the door closed and ends when the
+ * door opens again. The first report after a restart only latches the state of the car.
+ *
+ * @param[in,out] kpi        KPIs to update.
+ * @param[in]     floor      Floor of the car.
+ * @param[in]     door_open  The door is open.
+ * @param[in]     moving     The car is moving.
+ * @param[in]     reset      The controller requested the reset of the call of the floor.
+ */
+KPI_API void Kpi_cycle(Kpi *kpi, const uint8_t floor, const bool door_open, const bool moving, const bool reset)
+{
+    kpi->cycle++;
+    if (floor >= kpi->floors)
+    {
+        kpi->known = false;
+        return;
+    }
+
+    if (reset && door_open && (kpi->call_cycle[floor] != KPI_NO_CALL))
+    {
+        record(&kpi->floor[floor].service, &kpi->all.service, kpi->cycle - kpi->call_cycle[floor]);
+        kpi->call_cycle[floor] = KPI_NO_CALL;
+    }
+
+    if (!kpi->known)
+    {
+        /* The start of an open door or a trip in progress is unknown, neither is counted. */
+        kpi->door_since = 0U;
+        kpi->trip_since = moving ? TRIP_UNKNOWN : 0U;
+    }
+    else if (door_open != kpi->door_open)
+    {
+        if (door_open)
+        {
+            kpi->door_since = kpi->cycle;
+            if ((kpi->trip_since != 0U) && (kpi->trip_since != TRIP_UNKNOWN))
+            {
+                record(&kpi->floor[floor].travel, &kpi->all.travel, kpi->cycle - kpi->trip_since);
+            }
+            kpi->trip_since = 0U;
+        }
+        else if (kpi->door_since != 0U)
+        {
+            record(&kpi->floor[floor].dwell, &kpi->all.dwell, kpi->cycle - kpi->door_since);
+        }
+    }
+
+    if (moving && !door_open && (kpi->trip_since == 0U))
+    {
+        kpi->trip_since = kpi->cycle;
+    }
+
+    kpi->known = true;
+    kpi->door_open = door_open;
+}
+
+/**
+ * @brief Counts the unserved calls of a floor.
+ *
+ * @param[in] kpi    KPIs to evaluate.
+ * @param[in] floor  Floor.
+ * @return Number of unserved calls, including the pending one.
+ */
+KPI_API uint64_t Kpi_unserved(const Kpi *kpi, const uint8_t floor)
+{
+    if (floor >= KPI_MAX_FLOORS)
+    {
+        return 0U;
+    }
+
+    return kpi->dropped[floor] + ((kpi->call_cycle[floor] != KPI_NO_CALL) ? 1U : 0U);
+}
+
+/**
+ * @brief Adds the samples and the unserved calls of other KPIs.
+ *
+ * @param[in,out] kpi    KPIs to add to.
+ * @param[in]     other  KPIs to add.
+ * @return 0 on success, -EINVAL if other has more floors.
+ */
+KPI_API int Kpi_merge(Kpi *kpi, const Kpi *other)
+{
+    if (other->floors > kpi->floors)
+    {
+        return -EINVAL;
+    }
+
+    for (uint8_t k = 0U; k < other->floors; k++)
+    {
+        kpi->dropped[k] += Kpi_unserved(other, k);
+        merge_histos(&kpi->floor[k], &other->floor[k]);
+    }
+    merge_histos(&kpi->all, &other->all);
+    kpi->cycle += other->cycle;
+
+    return 0;
+}
+
+/**
+ * @brief Writes a string as a JSON string literal.
+ */
+static void write_string(FILE *file, const char *text)
+{
+    fputc('"', file);
+    for (const unsigned char *c = (const unsigned char *)text; *c != '\0'; c++)
+    {
+        if ((*c == '"') || (*c == '\\'))
+        {
+            fprintf(file, "\\%c", *c);
+        }
+        else if (*c < 0x20U)
+        {
+            fprintf(file, "\\u%04x", *c);
+        }
+        else
+        {
+            fputc(*c, file);
+        }
+    }
+    fputc('"', file);
+}
+
+/**
+ * @brief Writes the members of the histograms of a floor, or of all floors.
+ */
+static void write_histos(FILE *file, const Kpi_Histos *histos)
+{
+    fprintf(file, "\"service\": ");
+    Histo_write_json(&histos->service, file);
+    fprintf(file, ", \"dwell\": ");
+    Histo_write_json(&histos->dwell, file);
+    fprintf(file, ", \"travel\": ");
+    Histo_write_json(&histos->travel, file);
+}
+
+/**
+ * @brief Writes the KPIs of one scenario, or of the total, as a JSON object.
+ */
+static void write_kpi(FILE *file, const Kpi *kpi, const char *name, const char *indent)
+{
+    fprintf(file, "{");
+    if (name != NULL)
+    {
+        fprintf(file, "\"name\": ");
+        write_string(file, name);
+        fprintf(file, ", ");
+    }
+
+    uint64_t unserved = 0U;
+    for (uint8_t k = 0U; k < kpi->floors; k++)
+    {
+        unserved += Kpi_unserved(kpi, k);
+    }
+    fprintf(file, "\"cycles\": %llu, \"unserved\": %llu,\n%s  ", (unsigned long long)kpi->cycle,
+            (unsigned long long)unserved, indent);
+    write_histos(file, &kpi->all);
+
+    fprintf(file, ",\n%s  \"floors\": [", indent);
+    for (uint8_t k = 0U; k < kpi->floors; k++)
+    {
+        fprintf(file, "%s\n%s    {\"floor\": %u, \"unserved\": %llu, ", (k == 0U) ? "" : ",", indent, (unsigned)k,
+                (unsigned long long)Kpi_unserved(kpi, k));
+        write_histos(file, &kpi->floor[k]);
+        fprintf(file, "}");
+    }
+    fprintf(file, "\n%s  ]}", indent);
+}
+
+/**
+ * @brief Writes the KPIs of scenarios and their merged total as a JSON document.
+ *
+ * @param[in] file   Stream to write to.
+ * @param[in] kpis   KPIs of the scenarios.
+ * @param[in] names  Names of the scenarios.
+ * @param[in] count  Number of scenarios.
+ * @return 0 on success, negative errno value otherwise.
+ */
+KPI_API int Kpi_write_json(FILE *file, const Kpi *kpis, const char *const *names, const uint32_t count)
+{
+    Kpi *total = malloc(sizeof(Kpi));
+    if (total == NULL)
+    {
+        return -ENOMEM;
+    }
+
+    Kpi_init(total, (count != 0U) ? kpis[0].floors : 1U);
+    for (uint32_t i = 0U; i < count; i++)
+    {
+        if (Kpi_merge(total, &kpis[i]) != 0)
+        {
+            free(total);
+            return -EINVAL;
+        }
+    }
+
+    fprintf(file, "{\n  \"unit\": \"cycles\",\n  \"scenarios\": [");
+    for (uint32_t i = 0U; i < count; i++)
+    {
+        fprintf(file, "%s\n    ", (i == 0U) ? "" : ",");
+        write_kpi(file, &kpis[i], names[i], "    ");
+    }
+    fprintf(file, "\n  ],\n  \"total\": ");
+    write_kpi(file, total, NULL, "  ");
+    fprintf(file, "\n}\n");
+
+    free(total);
+    return (ferror(file) != 0) ? -EIO : 0;
+}
@@ -0,0 +1,55 @@
+#include "lockstep.h"
+
+/**
+ * @brief Copies the state of a controller complemented, to store channel B or to take it back.
+ */
+static inline void complement_state(Controller *target, const Controller *source)
+{
+    target->state.pc = (uint8_t)~source->state.pc;
+    target->instruction = (uint16_t)~source->instruction;
+}
+
+/**
+ * @brief Returns both channels to their power-up state and releases the safe stop.
+ *
+ * @param[out] lockstep  Redundant controller to initialize.
+ */
+LOCKSTEP_API void Lockstep_init(Lockstep *lockstep)
+{
+    Controller_init(&lockstep->channel);
+    complement_state(&lockstep->shadow, &lockstep->channel);
+    lockstep->safe_stop = false;
+}
+
+/**
+ * @brief Steps both channels by one cycle and compares them.
+ *
+ * Channel B is taken back to plain form in a local controller. Its stored state is compared with
+ * the one of channel A field by field before the step, its new instruction word with the one of
+ * channel A after it. Both channels are stepped even after a safe stop, only the returned
+ * instruction is replaced.
+ *
+ * @param[in,out] lockstep  Redundant controller to step.
+ * @param[in]     sensors   Packed sensor word of the cycle.
+ * @return The new instruction word, LOCKSTEP_SAFE_STOP if the channels disagreed.
+ */
+LOCKSTEP_API uint16_t Lockstep_step(Lockstep *lockstep, const uint8_t sensors)
+{
+    Controller *channel = &lockstep->channel;
+    Controller shadow;
+    complement_state(&shadow, &lockstep->shadow);
+
+    bool mismatch = (channel->state.pc != shadow.state.pc) || (channel->instruction != shadow.instruction);
+
+    uint16_t instruction = Controller_step(channel, sensors);
+    mismatch = (Controller_step(&shadow, sensors) != instruction) || mismatch;
+    complement_state(&lockstep->shadow, &shadow);
+
+    if (lockstep->safe_stop || mismatch)
+    {
+        lockstep->safe_stop = true;
+        return LOCKSTEP_SAFE_STOP;
+    }
+
+    return instruction;
+}
@@ -0,0 +1,321 @@
+#include "plant.h"
+#include "condsel.h"
+#include "seqnet.h"
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+
+/**
+ * @brief Limits a value to [-limit, limit].
+ *
+ * Unlike fminf()/fmaxf() the comparisons have no NaN semantics, so they map to vector min/max.
+ *
+ * @param[in] value  Value to limit.
+ * @param[in] limit  Non-negative limit.
+ * @return Limited value.
+ */
+static inline float clamp_symmetric(const float value, const float limit)
+{
+    float upper = (value < limit) ? value : limit;
+    return (upper > -limit) ? upper : -limit;
+}
+
+/**
+ * @brief Fills a configuration with the parameters of a typical low-rise passenger elevator.
+ *
+ * @param[out] config  Configuration to fill.
+ * @param[in]  floors  Number of floors.
+ */
+PLANT_API void Plant_default_config(Plant_Config *config, const uint8_t floors)
+{
+    config->floors = floors;
+    config->floor_height = 3.0f;
+    config->max_speed = 1.0f;
+    config->max_accel = 0.8f;
+    config->door_time = 2.0f;
+    config->level_tolerance = 0.01f;
+}
+
+/**
+ * @brief Allocates the cars, all standing level on floor 0 with open door.
+ *
+ * @param[out] plant   Plant to create.
+ * @param[in]  count   Number of cars.
+ * @param[in]  config  Mechanical parameters.
+ * @return 0 on success, -EINVAL on invalid parameters, -ENOMEM if the allocation failed.
+ */
+PLANT_API int Plant_create(Plant *plant, const uint32_t count, const Plant_Config *config)
+{
+    if ((count == 0U) || (config->floors < 2U) || (config->floors > 32U) ||
+        !(config->floor_height > 0.0f) || !(config->max_speed > 0.0f) ||
+        !(config->max_accel > 0.0f) || !(config->door_time > 0.0f) ||
+        !(config->level_tolerance > 0.0f))
+    {
+        return -EINVAL;
+    }
+
+    plant->count = count;
+    plant->config = *config;
+    plant->position = calloc(count, sizeof(float));
+    plant->velocity = calloc(count, sizeof(float));
+    plant->target = calloc(count, sizeof(float));
+    plant->door = calloc(count, sizeof(float));
+    plant->door_request = calloc(count, sizeof(float));
+
+    if ((plant->position == NULL) || (plant->velocity == NULL) || (plant->target == NULL) ||
+        (plant->door == NULL) || (plant->door_request == NULL))
+    {
+        Plant_destroy(plant);
+        return -ENOMEM;
+    }
+
+    for (uint32_t car = 0U; car < count; car++)
+    {
+        Plant_place(plant, car, 0U, true);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Frees the cars.
+ *
+ * @param[in,out] plant  Plant to free.
+ */
+PLANT_API void Plant_destroy(Plant *plant)
+{
+    free(plant->position);
+    free(plant->velocity);
+    free(plant->target);
+    free(plant->door);
+    free(plant->door_request);
+
+    plant->position = NULL;
+    plant->velocity = NULL;
+    plant->target = NULL;
+    plant->door = NULL;
+    plant->door_request = NULL;
+    plant->count = 0U;
+}
+
+/**
+ * @brief Places a car level on a floor with open or closed door, at rest.
+ *
+ * @param[in,out] plant      Plant of the car.
+ * @param[in]     car        Index of the car.
+ * @param[in]     floor      Floor to place the car on.
+ * @param[in]     door_open  Door fully open if true, closed otherwise.
+ */
+PLANT_API void Plant_place(Plant *plant, const uint32_t car, const uint8_t floor, const bool door_open)
+{
+    float position = (float)floor * plant->config.floor_height;
+
+    plant->position[car] = position;
+    plant->velocity[car] = 0.0f;
+    plant->target[car] = position;
+    plant->door[car] = door_open ? 1.0f : 0.0f;
+    plant->door_request[car] = plant->door[car];
+}
+
+/**
+ * @brief Applies the requests of an instruction word to a car.
+ *
+ * The door request is taken over unconditionally, Plant_step() holds the door while the car
+ * travels. A move request is only accepted from a car standing on its target with closed door,
+ * and makes the adjacent floor the target. Requesting both directions at once is ignored.
+ *
+ * @param[in,out] plant        Plant of the car.
+ * @param[in]     car          Index of the car.
+ * @param[in]     instruction  Instruction word of the controller of the car.
+ */
+PLANT_API void Plant_command(Plant *plant, const uint32_t car, const uint16_t instruction)
+{
+    plant->door_request[car] = SEQNET_DOOR_OPEN(instruction) ? 1.0f : 0.0f;
+
+    bool up = SEQNET_MOVE_UP(instruction);
+    bool down = SEQNET_MOVE_DOWN(instruction);
+    bool standing = (plant->velocity[car] == 0.0f) && (plant->position[car] == plant->target[car]);
+
+    if ((up == down) || !standing || (plant->door[car] > 0.0f))
+    {
+        return;
+    }
+
+    uint8_t floor = Plant_floor(plant, car);
+
+    if (up && ((floor + 1U) < plant->config.floors))
+    {
+        plant->target[car] = (float)(floor + 1U) * plant->config.floor_height;
+    }
+    else if (down && (floor > 0U))
+    {
+        plant->target[car] = (float)(floor - 1U) * plant->config.floor_height;
+    }
+}
+
+/**
+ * @brief Integrates all cars over a time step.
+ *
+ * The drive follows the fastest speed profile that still stops on the target with the
+ * acceleration limit, in discrete steps of dt: v = sqrt(dv^2 / 4 + 2 * max_accel * distance) - dv / 2
+ * with dv = max_accel * dt, capped at max_speed. The change of velocity is limited to dv, and a car
+ * that would reach or pass its target within the step is stopped on it. The door moves with constant speed towards the
+ * request while the car stands on its target, the car is held while the door is not closed.
+ *
+ * The loop body is free of branches and calls other than sqrtf, so it vectorizes (built with
+ * -fno-math-errno and -fno-trapping-math, @see CMakeLists.txt).
+ *
+ * @param[in,out] plant  Plant to integrate.
+ * @param[in]     dt     Time step [s].
+ */
+PLANT_API void Plant_step(Plant *plant, const float dt)
+{
+    const uint32_t count = plant->count;
+    const float max_speed = plant->config.max_speed;
+    const float max_dv = plant->config.max_accel * dt;
+    const float two_accel = 2.0f * plant->config.max_accel;
+    const float quarter_dv2 = 0.25f * max_dv * max_dv;
+    const float half_dv = 0.5f * max_dv;
+    const float max_door_step = dt / plant->config.door_time;
+
+    float *restrict position = plant->position;
+    float *restrict velocity = plant->velocity;
+    const float *restrict target = plant->target;
+    float *restrict door = plant->door;
+    const float *restrict door_request = plant->door_request;
+
+    for (uint32_t i = 0U; i < count; i++)
+    {
+        float distance = target[i] - position[i];
+        float closed = (door[i] <= 0.0f) ? 1.0f : 0.0f;
+
+        float profile = sqrtf(quarter_dv2 + (two_accel * fabsf(distance))) - half_dv;
+        float speed = (profile < max_speed) ? profile : max_speed;
+        float dv = (copysignf(speed, distance) * closed) - velocity[i];
+        float v = velocity[i] + clamp_symmetric(dv, max_dv);
+        float step = v * dt;
+        float moved = position[i] + step;
+
+        bool arrive = (fabsf(distance) <= fabsf(step));
+        position[i] = arrive ? target[i] : moved;
+        velocity[i] = arrive ? 0.0f : v;
+
+        float standing = (distance == 0.0f) ? max_door_step : 0.0f;
+        float door_step = door_request[i] - door[i];
+        door[i] += clamp_symmetric(door_step, standing);
+    }
+}
+
+/**
+ * @brief Calculates the floor nearest to a car.
+ *
+ * @param[in] plant  Plant of the car.
+ * @param[in] car    Index of the car.
+ * @return Nearest floor.
+ */
+PLANT_API uint8_t Plant_floor(const Plant *plant, const uint32_t car)
+{
+    float floor = roundf(plant->position[car] / plant->config.floor_height);
+    float top = (float)(plant->config.floors - 1U);
+
+    return (uint8_t)fminf(fmaxf(floor, 0.0f), top);
+}
+
+/**
+ * @brief Level detector: the car is within the level tolerance of a floor.
+ *
+ * @param[in] plant  Plant of the car.
+ * @param[in] car    Index of the car.
+ * @return True if the car is level with a floor.
+ */
+PLANT_API bool Plant_is_level(const Plant *plant, const uint32_t car)
+{
+    float level = (float)Plant_floor(plant, car) * plant->config.floor_height;
+
+    return fabsf(plant->position[car] - level) <= plant->config.level_tolerance;
+}
+
+/**
+ * @brief Door closed end-switch.
+ *
+ * @param[in] plant  Plant of the car.
+ * @param[in] car    Index of the car.
+ * @return True if the door is fully closed.
+ */
+PLANT_API bool Plant_is_door_closed(const Plant *plant, const uint32_t car)
+{
+    return plant->door[car] <= 0.0f;
+}
+
+/**
+ * @brief Door open end-switch.
+ *
+ * @param[in] plant  Plant of the car.
+ * @param[in] car    Index of the car.
+ * @return True if the door is fully open.
+ */
+PLANT_API bool Plant_is_door_open(const Plant *plant, const uint32_t car)
+{
+    return plant->door[car] >= 1.0f;
+}
+
+/**
+ * @brief Senses all inputs of a car into a packed sensor word.
+ *
+ * @param[in] plant          Plant of the car.
+ * @param[in] car            Index of the car.
+ * @param[in] pending_calls  Pending calls of the car, bit n: floor n.
+ * @return Packed sensor word.
+ */
+PLANT_API uint8_t Plant_sense(const Plant *plant, const uint32_t car, const uint32_t pending_calls)
+{
+    uint8_t floor = Plant_floor(plant, car);
+    uint32_t floor_bit = (uint32_t)1U << floor;
+
+    CondSel_In values = {
+        .call_pending_below = (pending_calls & (floor_bit - 1U)) != 0U,
+        .call_pending_same = (pending_calls & floor_bit) != 0U,
+        .call_pending_above = (pending_calls & ~((floor_bit << 1) - 1U)) != 0U,
+        .door_closed = Plant_is_door_closed(plant, car),
+        .door_open = Plant_is_door_open(plant, car)
+    };
+
+    return CondSel_pack(values, Plant_is_level(plant, car), values.door_closed || values.door_open);
+}
+
+/**
+ * @brief Level detector of the car in the context.
+ *
+ * @param[in] context  Plant_Car of the car.
+ * @return True if the car is level with a floor.
+ */
+static bool car_elevator_position_ok(void *context)
+{
+    const Plant_Car *car = context;
+    return Plant_is_level(car->plant, car->index);
+}
+
+/**
+ * @brief End-switches of the door of the car in the context.
+ *
+ * @param[in] context  Plant_Car of the car.
+ * @return True if the door is fully open or fully closed.
+ */
+static bool car_door_position_ok(void *context)
+{
+    const Plant_Car *car = context;
+    return Plant_is_door_closed(car->plant, car->index) || Plant_is_door_open(car->plant, car->index);
+}
+
+/**
+ * @brief Initializes a PosDet function table backed by the sensors of a car.
+ *
+ * @param[out] posdet   Function table to initialize.
+ * @param[in]  context  Car providing the signals.
+ */
+PLANT_API void Plant_init_posdet(PosDet_Ops *posdet, const Plant_Car *context)
+{
+    posdet->is_elevator_position_ok = car_elevator_position_ok;
+    posdet->is_door_position_ok = car_door_position_ok;
+    posdet->context = (void *)context;
+}
@@ -0,0 +1,292 @@
+#include "recorder.h"
+#include "controller.h"
+#include <errno.h>
+#include <string.h>
+
+/* FNV-1a parameters. */
+#define FNV_OFFSET_BASIS  2166136261UL
+#define FNV_PRIME         16777619UL
+
+/* Size of the stdio buffer of the file. */
+#define FILE_BUFFER_SIZE  (64U * 1024U)
+
+/* Maximum encoded length of a 64-bit varint. */
+#define VARINT_MAX_BYTES  10U
+
+static const uint8_t FileMagic[4] = {'E', 'L', 'R', 'R'};
+
+/**
+ * @brief Adds an instruction word to a digest.
+ *
+ * @param[in] digest       Digest so far.
+ * @param[in] instruction  Instruction word.
+ * @return The updated digest.
+ */
+static inline uint32_t digest_add(uint32_t digest, const uint16_t instruction)
+{
+    digest = (digest ^ (uint32_t)(instruction & 0xFFU)) * (uint32_t)FNV_PRIME;
+    digest = (digest ^ (uint32_t)(instruction >> 8)) * (uint32_t)FNV_PRIME;
+    return digest;
+}
+
+/**
+ * @brief Writes a varint (7 bits per byte, least significant first).
+ *
+ * @param[in] file   Output file.
+ * @param[in] value  Value to write.
+ */
+static void write_varint(FILE *file, uint64_t value)
+{
+    uint8_t bytes[VARINT_MAX_BYTES];
+    size_t length = 0U;
+
+    do
+    {
+        uint8_t byte = (uint8_t)(value & 0x7FU);
+        value >>= 7;
+        bytes[length++] = (value != 0U) ? (uint8_t)(byte | 0x80U) : byte;
+    } while (value != 0U);
+
+    (void)fwrite(bytes, 1U, length, file);
+}
+
+/**
+ * @brief Reads a varint.
+ *
+ * @param[in]  file   Input file.
+ * @param[out] value  Receives the value.
+ * @return 1 if a value was read, 0 at the end of the file, -EILSEQ if truncated or too long.
+ */
+static int read_varint(FILE *file, uint64_t *value)
+{
+    uint64_t result = 0U;
+
+    for (uint32_t i = 0U; i < VARINT_MAX_BYTES; i++)
+    {
+        int byte = getc(file);
+        if (byte == EOF)
+        {
+            return (i == 0U) ? 0 : -EILSEQ;
+        }
+
+        result |= (uint64_t)(byte & 0x7F) << (7U * i);
+        if ((byte & 0x80) == 0)
+        {
+            *value = result;
+            return 1;
+        }
+    }
+
+    return -EILSEQ;
+}
+
+/**
+ * @brief Writes the current run, if it has any cycles.
+ *
+ * @param[in,out] recorder  State of the recording.
+ */
+static void flush_run(Recorder *recorder)
+{
+    if (recorder->run_cycles == 0U)
+    {
+        return;
+    }
+
+    uint8_t tail[5];
+    tail[0] = recorder->run_sensors;
+    tail[1] = (uint8_t)recorder->run_digest;
+    tail[2] = (uint8_t)(recorder->run_digest >> 8);
+    tail[3] = (uint8_t)(recorder->run_digest >> 16);
+    tail[4] = (uint8_t)(recorder->run_digest >> 24);
+
+    write_varint(recorder->file, recorder->run_cycles);
+    (void)fwrite(tail, 1U, sizeof(tail), recorder->file);
+
+    recorder->runs++;
+    recorder->run_cycles = 0U;
+    recorder->run_digest = (uint32_t)FNV_OFFSET_BASIS;
+}
+
+/**
+ * @brief Creates the recording file.
+ *
+ * @param[out] recorder  State of the recording.
+ * @param[in]  path      Path of the file.
+ * @return 0 on success, negative errno value otherwise.
+ */
+RECORDER_API int Recorder_open(Recorder *recorder, const char *path)
+{
+    memset(recorder, 0, sizeof(*recorder));
+    recorder->run_digest = (uint32_t)FNV_OFFSET_BASIS;
+
+    recorder->file = fopen(path, "wb");
+    if (recorder->file == NULL)
+    {
+        return -errno;
+    }
+
+    (void)setvbuf(recorder->file, NULL, _IOFBF, FILE_BUFFER_SIZE);
+    (void)fwrite(FileMagic, 1U, sizeof(FileMagic), recorder->file);
+    (void)fputc((int)RECORDER_VERSION, recorder->file);
+
+    return 0;
+}
+
+/**
+ * @brief Records a controller reset.
+ *
+ * @param[in,out] recorder  State of the recording.
+ */
+RECORDER_API void Recorder_reset(Recorder *recorder)
+{
+    if (recorder->file == NULL)
+    {
+        return;
+    }
+
+    flush_run(recorder);
+    write_varint(recorder->file, 0U);
+}
+
+/**
+ * @brief Records a cycle.
+ *
+ * Extends the current run while the sensor word does not change.
+ *
+ * @param[in,out] recorder     State of the recording.
+ * @param[in]     sensors      Packed sensor word of the cycle.
+ * @param[in]     instruction  Instruction word of the cycle.
+ */
+RECORDER_API void Recorder_cycle(Recorder *recorder, const uint8_t sensors, const uint16_t instruction)
+{
+    if (recorder->file == NULL)
+    {
+        return;
+    }
+
+    if ((recorder->run_cycles != 0U) && (sensors != recorder->run_sensors))
+    {
+        flush_run(recorder);
+    }
+
+    recorder->run_sensors = sensors;
+    recorder->run_digest = digest_add(recorder->run_digest, instruction);
+    recorder->run_cycles++;
+    recorder->cycles++;
+}
+
+/**
+ * @brief Writes the last run and closes the file.
+ *
+ * @param[in,out] recorder  State of the recording.
+ * @return 0 on success, negative errno value if any write failed.
+ */
+RECORDER_API int Recorder_close(Recorder *recorder)
+{
+    if (recorder->file == NULL)
+    {
+        return 0;
+    }
+
+    flush_run(recorder);
+
+    int result = ferror(recorder->file) ? -EIO : 0;
+    if ((fclose(recorder->file) != 0) && (result == 0))
+    {
+        result = -errno;
+    }
+    recorder->file = NULL;
+
+    return result;
+}
+
+/**
+ * @brief Replays a recording against the controller.
+ *
+ * The cycle order is the same as in the recording application: step the controller on the sensor
+ * word of the previous cycle, then sense the word of the cycle.
+ *
+ * @param[in]  path    Path of the recording.
+ * @param[out] result  Statistics of the replay.
+ * @return 0 if the file was replayed completely, negative errno value otherwise.
+ */
+RECORDER_API int Recorder_replay(const char *path, Recorder_Result *result)
+{
+    memset(result, 0, sizeof(*result));
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return -errno;
+    }
+    (void)setvbuf(file, NULL, _IOFBF, FILE_BUFFER_SIZE);
+
+    uint8_t header[sizeof(FileMagic) + 1U];
+    if ((fread(header, 1U, sizeof(header), file) != sizeof(header)) ||
+        (memcmp(header, FileMagic, sizeof(FileMagic)) != 0) ||
+        (header[sizeof(FileMagic)] != RECORDER_VERSION))
+    {
+        (void)fclose(file);
+        return -EILSEQ;
+    }
+
+    Controller controller;
+    uint8_t sensed = 0U;
+    int status = 0;
+    Controller_init(&controller);
+
+    for (;;)
+    {
+        uint64_t run_cycles = 0U;
+        status = read_varint(file, &run_cycles);
+        if (status <= 0)
+        {
+            break;
+        }
+
+        if (run_cycles == 0U)
+        {
+            Controller_init(&controller);
+            sensed = 0U;
+            result->resets++;
+            continue;
+        }
+
+        uint8_t tail[5];
+        if (fread(tail, 1U, sizeof(tail), file) != sizeof(tail))
+        {
+            status = -EILSEQ;
+            break;
+        }
+        uint8_t sensors = tail[0];
+        uint32_t recorded_digest = (uint32_t)tail[1] | ((uint32_t)tail[2] << 8) |
+                                   ((uint32_t)tail[3] << 16) | ((uint32_t)tail[4] << 24);
+
+        uint32_t digest = (uint32_t)FNV_OFFSET_BASIS;
+        for (uint64_t i = 0U; i < run_cycles; i++)
+        {
+            digest = digest_add(digest, Controller_step(&controller, sensed));
+            sensed = sensors;
+        }
+
+        if (digest != recorded_digest)
+        {
+            if (result->mismatches == 0U)
+            {
+                result->first_mismatch = result->cycles;
+            }
+            result->mismatches++;
+        }
+
+        result->cycles += run_cycles;
+        result->runs++;
+    }
+
+    if (ferror(file))
+    {
+        status = -EIO;
+    }
+    (void)fclose(file);
+
+    return (status < 0) ? status : 0;
+}
@@ -0,0 +1,227 @@
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+#include "rtloop.h"
+#include <errno.h>
+
+#if defined(__linux__)
+
+#include <sched.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+
+#define NSEC_PER_SEC        1000000000ULL
+
+/* Size of the stack to pre-fault when the memory is locked. */
+#define PREFAULT_STACK_SIZE (64U * 1024U)
+
+/**
+ * @brief Reads the monotonic clock.
+ *
+ * @return Current time in nanoseconds.
+ */
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * NSEC_PER_SEC) + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Sleeps until an absolute time of the monotonic clock.
+ *
+ * @param[in] deadline_ns  Time to wake up at.
+ */
+static void sleep_until_ns(const uint64_t deadline_ns)
+{
+    struct timespec ts;
+    ts.tv_sec = (time_t)(deadline_ns / NSEC_PER_SEC);
+    ts.tv_nsec = (long)(deadline_ns % NSEC_PER_SEC);
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+    {
+    }
+}
+
+/**
+ * @brief Touches the stack so it does not page fault inside the loop.
+ */
+static void prefault_stack(void)
+{
+    volatile uint8_t stack[PREFAULT_STACK_SIZE];
+    memset((void *)stack, 0, sizeof(stack));
+}
+
+/** Settings of the calling thread before the configuration was applied. */
+typedef struct
+{
+    cpu_set_t affinity;
+    int policy;
+    struct sched_param param;
+} SavedConfig;
+
+/**
+ * @brief Applies the scheduling and memory configuration to the calling thread.
+ *
+ * @param[in]  config  Configuration of the runner.
+ * @param[out] saved   Receives the settings the configuration replaces.
+ * @return 0 on success, negative errno value otherwise.
+ */
+static int apply_config(const RtLoop_Config *config, SavedConfig *saved)
+{
+    if (config->cpu >= 0)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(config->cpu, &set);
+        if ((sched_getaffinity(0, sizeof(saved->affinity), &saved->affinity) != 0) ||
+            (sched_setaffinity(0, sizeof(set), &set) != 0))
+        {
+            return -errno;
+        }
+    }
+
+    if (config->lock_memory)
+    {
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+        {
+            return -errno;
+        }
+        prefault_stack();
+    }
+
+    if (config->fifo_priority > 0)
+    {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = config->fifo_priority;
+        saved->policy = sched_getscheduler(0);
+        if ((saved->policy < 0) || (sched_getparam(0, &saved->param) != 0) ||
+            (sched_setscheduler(0, SCHED_FIFO, &param) != 0))
+        {
+            return -errno;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Restores the settings replaced by the configuration, in reverse order.
+ *
+ * Also called after a failed apply_config(), settings which were not saved are left alone.
+ *
+ * @param[in] config  Configuration of the runner.
+ * @param[in] saved   Settings before the configuration was applied.
+ */
+static void restore_config(const RtLoop_Config *config, const SavedConfig *saved)
+{
+    if ((config->fifo_priority > 0) && (saved->policy >= 0))
+    {
+        (void)sched_setscheduler(0, saved->policy, &saved->param);
+    }
+
+    if (config->lock_memory)
+    {
+        (void)munlockall();
+    }
+
+    if ((config->cpu >= 0) && (CPU_COUNT(&saved->affinity) > 0))
+    {
+        (void)sched_setaffinity(0, sizeof(saved->affinity), &saved->affinity);
+    }
+}
+
+/**
+ * @brief Runs the cycle function at a fixed period.
+ *
+ * Every release time is a multiple of the period after the start, so the jitter does not
+ * accumulate. The wake-up jitter is measured before calling the cycle function, the overrun
+ * after it against the release of the next cycle. The settings of the calling thread are
+ * restored before returning.
+ *
+ * @param[in]  config   Configuration of the runner.
+ * @param[in]  cycle    Cycle function.
+ * @param[in]  context  Passed to the cycle function.
+ * @param[out] stats    Statistics of the run.
+ * @return 0 on success, negative errno value if the configuration could not be applied.
+ */
+RTLOOP_API int RtLoop_run(const RtLoop_Config *config, RtLoop_CycleFn cycle, void *context, RtLoop_Stats *stats)
+{
+    Histo_init(&stats->jitter);
+    Histo_init(&stats->exec);
+    Histo_init(&stats->overrun);
+    stats->cycles = 0U;
+    stats->overruns = 0U;
+    stats->missed = 0U;
+
+    if (config->period_ns == 0U)
+    {
+        return -EINVAL;
+    }
+
+    SavedConfig saved;
+    memset(&saved, 0, sizeof(saved));
+    saved.policy = -1;
+
+    int result = apply_config(config, &saved);
+    if (result != 0)
+    {
+        restore_config(config, &saved);
+        return result;
+    }
+
+    uint64_t release = now_ns() + config->period_ns;
+    bool running = true;
+
+    while (running && ((config->cycles == 0U) || (stats->cycles < config->cycles)))
+    {
+        sleep_until_ns(release);
+
+        uint64_t start = now_ns();
+        Histo_record(&stats->jitter, (start > release) ? (start - release) : 0U);
+
+        running = cycle(context);
+
+        uint64_t end = now_ns();
+        Histo_record(&stats->exec, end - start);
+        stats->cycles++;
+
+        /* Move to the next release, skipping the ones which already passed. */
+        release += config->period_ns;
+        if (end > release)
+        {
+            uint64_t late = end - release;
+            uint64_t skipped = (late / config->period_ns) + 1U;
+
+            Histo_record(&stats->overrun, late);
+            stats->overruns++;
+            stats->missed += skipped;
+            release += skipped * config->period_ns;
+        }
+    }
+
+    restore_config(config, &saved);
+    return 0;
+}
+
+#else
+
+/**
+ * @brief Fixed-rate runner is not available on this platform.
+ *
+ * @return -ENOSYS.
+ */
+RTLOOP_API int RtLoop_run(const RtLoop_Config *config, RtLoop_CycleFn cycle, void *context, RtLoop_Stats *stats)
+{
+    (void)config;
+    (void)cycle;
+    (void)context;
+    (void)stats;
+
+    return -ENOSYS;
+}
+
+#endif
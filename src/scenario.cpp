@@ -0,0 +1,257 @@
+#include "scenario.hpp"
+#include <stdexcept>
+
+namespace elevator {
+
+/**
+ * @brief Checks a condition now, the scenario does not suspend if it already holds.
+ */
+bool Condition::await_ready() const noexcept {
+    return scheduler->check(car, wait, floor);
+}
+
+/**
+ * @brief Parks the scenario on its car until the condition holds.
+ *
+ * Conditions only change when the cars are stepped, so the car is checked again after the
+ * steps that change its sensed state.
+ */
+void Condition::await_suspend(std::coroutine_handle<> handle) const {
+    std::vector<Scheduler::Waiter> &waiters = scheduler->waiters_[car];
+    if (waiters.empty()) {
+        scheduler->watched_.push_back(car);
+        scheduler->snapshots_[car] = scheduler->snapshot(car);
+    }
+    waiters.push_back({handle, wait, floor});
+}
+
+/**
+ * @brief Parks the scenario until the given number of cycles is stepped.
+ */
+void Cycles::await_suspend(std::coroutine_handle<> handle) const {
+    scheduler->timers_.push({scheduler->cycle_ + count, scheduler->timer_order_++, handle});
+}
+
+uint64_t Car::cycle() const {
+    return scheduler_->cycle_;
+}
+
+uint8_t Car::floor() const {
+    return Plant_floor(&scheduler_->plant_, index_);
+}
+
+bool Car::level() const {
+    return Plant_is_level(&scheduler_->plant_, index_);
+}
+
+bool Car::door_open() const {
+    return Plant_is_door_open(&scheduler_->plant_, index_);
+}
+
+bool Car::door_closed() const {
+    return Plant_is_door_closed(&scheduler_->plant_, index_);
+}
+
+uint32_t Car::pending_calls() const {
+    return scheduler_->calls_[index_];
+}
+
+/**
+ * @brief Posts a call, floors out of range are ignored.
+ */
+void Car::call(uint8_t floor) const {
+    if (floor < scheduler_->plant_.config.floors) {
+        scheduler_->calls_[index_] |= (uint32_t)1U << floor;
+    }
+}
+
+Scheduler::Scheduler(uint32_t cars, const Plant_Config &config, float dt) : dt_(dt) {
+    if (Plant_create(&plant_, cars, &config) != 0) {
+        throw std::runtime_error("Plant_create failed");
+    }
+
+    batch_ = elev_batch_create(cars);
+    if (batch_ == nullptr) {
+        Plant_destroy(&plant_);
+        throw std::runtime_error("elev_batch_create failed");
+    }
+
+    calls_.assign(cars, 0U);
+    sensors_.assign(cars, 0U);
+    outputs_.assign(cars, 0U);
+    waiters_.resize(cars);
+    snapshots_.assign(cars, 0U);
+}
+
+/**
+ * @brief Destroys the scenarios that have not finished, with the subroutines they wait in.
+ */
+Scheduler::~Scheduler() {
+    for (std::coroutine_handle<Scenario::promise_type> root : roots_) {
+        if (root) {
+            root.destroy();
+        }
+    }
+
+    elev_batch_destroy(batch_);
+    Plant_destroy(&plant_);
+}
+
+void Scheduler::spawn(Scenario scenario) {
+    std::coroutine_handle<Scenario::promise_type> handle = std::exchange(scenario.handle_, {});
+    if (!handle) {
+        return;
+    }
+
+    uint32_t root;
+    if (free_roots_.empty()) {
+        root = (uint32_t)roots_.size();
+        roots_.push_back(handle);
+    } else {
+        root = free_roots_.back();
+        free_roots_.pop_back();
+        roots_[root] = handle;
+    }
+
+    handle.promise().scheduler = this;
+    handle.promise().root = root;
+    ready_.push_back(handle);
+    live_++;
+}
+
+uint64_t Scheduler::run(uint64_t max_cycles) {
+    uint64_t stepped = 0U;
+
+    resume_ready();
+    while ((live_ > 0U) && (stepped < max_cycles) && !exception_) {
+        step();
+        stepped++;
+        wake();
+        resume_ready();
+    }
+
+    if (exception_) {
+        std::rethrow_exception(std::exchange(exception_, nullptr));
+    }
+
+    return stepped;
+}
+
+bool Scheduler::check(uint32_t car, Wait wait, uint8_t floor) const {
+    switch (wait) {
+        case Wait::Floor:
+            return (plant_.velocity[car] == 0.0f) && Plant_is_level(&plant_, car) && (Plant_floor(&plant_, car) == floor);
+        case Wait::DoorOpen:
+            return Plant_is_door_open(&plant_, car);
+        case Wait::DoorClosed:
+            return Plant_is_door_closed(&plant_, car);
+        case Wait::Served:
+            return (calls_[car] & ((uint32_t)1U << floor)) == 0U;
+        case Wait::Idle:
+            return (calls_[car] == 0U) && Plant_is_door_open(&plant_, car);
+    }
+
+    return false;
+}
+
+/**
+ * @brief Sensed state of a car, every condition is a function of it.
+ */
+uint64_t Scheduler::snapshot(uint32_t car) const {
+    uint64_t standing = (plant_.velocity[car] == 0.0f) ? 1U : 0U;
+    uint64_t sensed = Plant_sense(&plant_, car, 0U);
+    uint64_t floor = Plant_floor(&plant_, car);
+
+    return ((uint64_t)calls_[car] << 16) | (floor << 8) | (sensed << 1) | standing;
+}
+
+/**
+ * @brief Steps all cars by one control cycle, the way the closed loop of bench_plant does.
+ */
+void Scheduler::step() {
+    const uint32_t cars = plant_.count;
+
+    for (uint32_t car = 0U; car < cars; car++) {
+        sensors_[car] = Plant_sense(&plant_, car, calls_[car]);
+    }
+
+    (void)elev_batch_step(batch_, sensors_.data(), outputs_.data(), 1U);
+
+    for (uint32_t car = 0U; car < cars; car++) {
+        if (((outputs_[car] & ELEV_OUT_RESET_CALL) != 0U) && Plant_is_level(&plant_, car)) {
+            calls_[car] &= ~((uint32_t)1U << Plant_floor(&plant_, car));
+        }
+        Plant_command(&plant_, car, outputs_[car]);
+    }
+
+    Plant_step(&plant_, dt_);
+    cycle_++;
+}
+
+/**
+ * @brief Moves the scenarios whose timer expired or whose condition fired to the ready list.
+ */
+void Scheduler::wake() {
+    while (!timers_.empty() && (timers_.top().cycle <= cycle_)) {
+        ready_.push_back(timers_.top().handle);
+        timers_.pop();
+    }
+
+    for (size_t i = 0U; i < watched_.size();) {
+        uint32_t car = watched_[i];
+        uint64_t state = snapshot(car);
+        if (state == snapshots_[car]) {
+            i++;
+            continue;
+        }
+        snapshots_[car] = state;
+
+        std::vector<Waiter> &waiters = waiters_[car];
+        for (size_t w = 0U; w < waiters.size();) {
+            if (check(car, waiters[w].wait, waiters[w].floor)) {
+                ready_.push_back(waiters[w].handle);
+                waiters[w] = waiters.back();
+                waiters.pop_back();
+            } else {
+                w++;
+            }
+        }
+
+        if (waiters.empty()) {
+            watched_[i] = watched_.back();
+            watched_.pop_back();
+        } else {
+            i++;
+        }
+    }
+}
+
+void Scheduler::resume_ready() {
+    std::vector<std::coroutine_handle<>> ready;
+    ready.swap(ready_);
+
+    for (std::coroutine_handle<> handle : ready) {
+        handle.resume();
+    }
+
+    ready.clear();
+    if (ready_.empty()) {
+        ready_.swap(ready);
+    }
+}
+
+/**
+ * @brief Called by a spawned scenario when it completes, frees its frame.
+ */
+void Scheduler::finish(uint32_t root, std::exception_ptr exception) {
+    roots_[root].destroy();
+    roots_[root] = {};
+    free_roots_.push_back(root);
+    live_--;
+
+    if (exception && !exception_) {
+        exception_ = exception;
+    }
+}
+
+} // namespace elevator
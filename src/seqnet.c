@@ -1,8 +1,9 @@
 #include "seqnet.h"
+#include "condsel.h"
 #include <stdbool.h>
 #include <stdint.h>
 
-#define PROG_MEM_SIZE 256U
+#define PROG_MEM_SIZE SEQNET_PROG_MEM_SIZE
 
 /* Bit positions of instructions. */
 #define BIT_POS_INV         15U
@@ -16,6 +17,10 @@
 #define MASK_COND_SEL       0x7U
 #define MASK_JUMP_ADDR      0xFFU
 
+/* Masks for the dispatch key, selected by the inversion bit of a dispatch instruction. */
+#define MASK_DISPATCH_CALLS (CONDSEL_VEC_BELOW | CONDSEL_VEC_SAME | CONDSEL_VEC_ABOVE)
+#define MASK_DISPATCH_DOOR  (MASK_DISPATCH_CALLS | CONDSEL_VEC_DOOR_CLOSED)
+
 /* Pre-shifted bit masks for constructing single-bit instruction fields. */
 #define FIELD_INV           (1U << BIT_POS_INV)
 #define FIELD_RESET         (1U << BIT_POS_RESET)
@@ -23,8 +28,8 @@
 #define FIELD_DOWN          (1U << BIT_POS_DOWN)
 #define FIELD_UP            (1U << BIT_POS_UP)
 
-/* Program Counter. */
-static uint8_t PC;
+/* State (Program Counter) of the default instance. */
+static SeqNet_State State;
 
 /* Condition Selector index values. */
 typedef enum {
@@ -34,7 +39,7 @@ typedef enum {
     COND_CALL_ABOVE   = 3,
     COND_DOOR_CLOSED  = 4,
     COND_DOOR_OPEN    = 5,
-    COND_RESERVED     = 6,
+    COND_DISPATCH     = CONDSEL_INDEX_DISPATCH,
     COND_ALWAYS_FALSE = 7
 } ConditionIndex;
 
@@ -45,6 +50,7 @@ typedef enum {
 #define COND_SEL_CALL_ABOVE   ((uint16_t)COND_CALL_ABOVE << BIT_POS_COND_SEL)
 #define COND_SEL_DOOR_CLOSED  ((uint16_t)COND_DOOR_CLOSED << BIT_POS_COND_SEL)
 #define COND_SEL_DOOR_OPEN    ((uint16_t)COND_DOOR_OPEN << BIT_POS_COND_SEL)
+#define COND_SEL_DISPATCH     ((uint16_t)COND_DISPATCH << BIT_POS_COND_SEL)
 #define COND_SEL_ALWAYS_FALSE ((uint16_t)COND_ALWAYS_FALSE << BIT_POS_COND_SEL)
 
 /* Program Counter locations, defining the states of the machine. */
@@ -52,12 +58,17 @@ typedef enum {
     STATE_INIT          = 0,  /* Length: 1. */
     STATE_IDLE          = 1,  /* Length: 3. */
     STATE_CLOSE_DOOR    = 4,  /* Length: 2. */
-    STATE_CHOOSE_DIR    = 6,  /* Length: 4. */
-    STATE_MOVE_UP       = 10, /* Length: 2. */
-    STATE_MOVE_DOWN     = 12, /* Length: 2. */
-    STATE_ARRIVED       = 14  /* Length: 2. */
+    STATE_CHOOSE_DIR    = 6,  /* Length: 1. */
+    STATE_MOVE_UP       = 7,  /* Length: 2. */
+    STATE_MOVE_DOWN     = 9,  /* Length: 2. */
+    STATE_ARRIVED       = 11  /* Length: 2. */
 } ProgramState;
 
+/* Jump tables of the dispatch instructions. */
+typedef enum {
+    TABLE_CHOOSE_DIR    = 13  /* Length: 8. */
+} JumpTable;
+
 /* The program memory defines the elevator's state machine logic. */
 static const uint16_t ProgMem[PROG_MEM_SIZE] = {
     /*
@@ -83,12 +94,9 @@ static const uint16_t ProgMem[PROG_MEM_SIZE] = {
 
     /*
      * STATE: CHOOSE_DIRECTION.
-     * Purpose: Door is closed. Decide which direction to move.
+     * Purpose: Door is closed. Decide which direction to move in a single dispatch.
      */
-    [STATE_CHOOSE_DIR]   = COND_SEL_CALL_ABOVE | (uint16_t)STATE_MOVE_UP,
-    [STATE_CHOOSE_DIR+1] = COND_SEL_CALL_BELOW | (uint16_t)STATE_MOVE_DOWN,
-    [STATE_CHOOSE_DIR+2] = COND_SEL_CALL_SAME | (uint16_t)STATE_ARRIVED,
-    [STATE_CHOOSE_DIR+3] = FIELD_INV | COND_SEL_ALWAYS_FALSE | (uint16_t)STATE_IDLE,
+    [STATE_CHOOSE_DIR] = COND_SEL_DISPATCH | (uint16_t)TABLE_CHOOSE_DIR,
 
     /*
      * STATE: MOVE_UP.
@@ -109,7 +117,20 @@ static const uint16_t ProgMem[PROG_MEM_SIZE] = {
      * Purpose: Arrived at a destination floor.
      */
     [STATE_ARRIVED]   = COND_SEL_DOOR_OPEN | FIELD_RESET | FIELD_DOOR_OPEN | (uint16_t)STATE_IDLE,
-    [STATE_ARRIVED+1] = FIELD_INV | COND_SEL_ALWAYS_FALSE | FIELD_RESET | FIELD_DOOR_OPEN | (uint16_t)STATE_ARRIVED
+    [STATE_ARRIVED+1] = FIELD_INV | COND_SEL_ALWAYS_FALSE | FIELD_RESET | FIELD_DOOR_OPEN | (uint16_t)STATE_ARRIVED,
+
+    /*
+     * TABLE: CHOOSE_DIRECTION.
+     * Purpose: Keyed on the call bits. Above has priority over below, below over same.
+     */
+    [TABLE_CHOOSE_DIR]                                                           = (uint16_t)STATE_IDLE,
+    [TABLE_CHOOSE_DIR + CONDSEL_VEC_BELOW]                                       = (uint16_t)STATE_MOVE_DOWN,
+    [TABLE_CHOOSE_DIR + CONDSEL_VEC_SAME]                                        = (uint16_t)STATE_ARRIVED,
+    [TABLE_CHOOSE_DIR + CONDSEL_VEC_SAME + CONDSEL_VEC_BELOW]                    = (uint16_t)STATE_MOVE_DOWN,
+    [TABLE_CHOOSE_DIR + CONDSEL_VEC_ABOVE]                                       = (uint16_t)STATE_MOVE_UP,
+    [TABLE_CHOOSE_DIR + CONDSEL_VEC_ABOVE + CONDSEL_VEC_BELOW]                   = (uint16_t)STATE_MOVE_UP,
+    [TABLE_CHOOSE_DIR + CONDSEL_VEC_ABOVE + CONDSEL_VEC_SAME]                    = (uint16_t)STATE_MOVE_UP,
+    [TABLE_CHOOSE_DIR + CONDSEL_VEC_ABOVE + CONDSEL_VEC_SAME + CONDSEL_VEC_BELOW] = (uint16_t)STATE_MOVE_UP
 };
 
 
@@ -118,49 +139,170 @@ static const uint16_t ProgMem[PROG_MEM_SIZE] = {
  */
 void SeqNet_init(void)
 {
-    PC = 0U;
+    SeqNet_init_state(&State);
 }
 
 /**
- * @brief Steps the sequential network to the next state.
+ * @brief Initializes the ProgramCounter of an instance.
+ *
+ * @param[out] state  State of the instance.
+ */
+void SeqNet_init_state(SeqNet_State *state)
+{
+    state->pc = 0U;
+}
+
+/**
+ * @brief Steps a sequential network over a program image and returns the raw instruction.
  *
  * This function performs one cycle of the network. It first determines the
  * next value of the Program Counter (PC) based on the result of the previous
- * cycle's condition. Then, it fetches and decodes the instruction at the new PC
- * location and returns it.
+ * cycle's condition. Then, it fetches the instruction at the new PC location.
+ * Dispatch instructions load the next PC from their jump table, indexed by the
+ * packed condition vector.
  *
- * @param[in] condition_active  The result of the condition check from the previous cycle.
- * @return The new instruction containing requests for the system and condition
- * selection for the next cycle.
+ * @param[in]     image      Program image.
+ * @param[in,out] state      State of the instance.
+ * @param[in]     condition  The condition value from the previous cycle.
+ * @return The new instruction word.
  */
-SeqNet_Out SeqNet_loop(const bool condition_active)
+static inline uint16_t step_image(const uint16_t *image, SeqNet_State *state, const uint8_t condition)
 {
+    uint8_t pc = state->pc;
+
     /* Read the jump address from the instruction at the CURRENT PC. */
-    uint16_t current_instruction = ProgMem[PC];
+    uint16_t current_instruction = image[pc];
     uint8_t jump_addr = (uint8_t)(current_instruction & MASK_JUMP_ADDR);
+    uint8_t cond_sel = (uint8_t)((current_instruction >> BIT_POS_COND_SEL) & MASK_COND_SEL);
 
     /* Update the PC for the next cycle based on the condition result. */
-    if (condition_active)
+    if (cond_sel == (uint8_t)COND_DISPATCH)
+    {
+        uint8_t key_mask = ((current_instruction & FIELD_INV) != 0U) ? MASK_DISPATCH_DOOR : MASK_DISPATCH_CALLS;
+        pc = (uint8_t)(image[(uint8_t)(jump_addr + (condition & key_mask))] & MASK_JUMP_ADDR);
+    }
+    else if (condition != 0U)
     {
-        PC = jump_addr;
+        pc = jump_addr;
     }
     else
     {
-        PC++;
+        pc++;
     }
 
+    state->pc = pc;
+
     /* Load the instruction at the new PC location. */
-    uint16_t new_instruction = ProgMem[PC];
+    return image[pc];
+}
+
+/**
+ * @brief Steps the sequential network of an instance and returns the raw instruction.
+ *
+ * @param[in,out] state      State of the instance.
+ * @param[in]     condition  The condition value from the previous cycle.
+ * @return The new instruction word.
+ */
+uint16_t SeqNet_step_raw(SeqNet_State *state, const uint8_t condition)
+{
+    return step_image(ProgMem, state, condition);
+}
+
+/**
+ * @brief Steps the sequential network of an instance over a program image.
+ *
+ * @param[in]     image      Program image of PROG_MEM_SIZE instruction words.
+ * @param[in,out] state      State of the instance.
+ * @param[in]     condition  The condition value from the previous cycle.
+ * @return The new instruction word.
+ */
+uint16_t SeqNet_step_image(const uint16_t *image, SeqNet_State *state, const uint8_t condition)
+{
+    return step_image(image, state, condition);
+}
 
-    /* Decode the new instruction into the output struct. */
+/**
+ * @brief Returns the built-in program.
+ *
+ * @return The program memory of PROG_MEM_SIZE instruction words.
+ */
+const uint16_t *SeqNet_program(void)
+{
+    return ProgMem;
+}
+
+/**
+ * @brief Decodes an instruction word into the output struct.
+ *
+ * @param[in] instruction  Instruction word.
+ * @return The decoded instruction.
+ */
+SeqNet_Out SeqNet_decode(const uint16_t instruction)
+{
     SeqNet_Out out;
-    out.jump_addr = (uint8_t)(new_instruction & MASK_JUMP_ADDR);
-    out.req_move_up = (bool)((new_instruction >> BIT_POS_UP) & 1U);
-    out.req_move_down = (bool)((new_instruction >> BIT_POS_DOWN) & 1U);
-    out.req_door_state = (bool)((new_instruction >> BIT_POS_DOOR) & 1U);
-    out.req_reset = (bool)((new_instruction >> BIT_POS_RESET) & 1U);
-    out.cond_sel = (uint8_t)((new_instruction >> BIT_POS_COND_SEL) & MASK_COND_SEL);
-    out.cond_inv = (bool)((new_instruction >> BIT_POS_INV) & 1U);
+    out.jump_addr = (uint8_t)(instruction & MASK_JUMP_ADDR);
+    out.req_move_up = (bool)((instruction >> BIT_POS_UP) & 1U);
+    out.req_move_down = (bool)((instruction >> BIT_POS_DOWN) & 1U);
+    out.req_door_state = (bool)((instruction >> BIT_POS_DOOR) & 1U);
+    out.req_reset = (bool)((instruction >> BIT_POS_RESET) & 1U);
+    out.cond_sel = (uint8_t)((instruction >> BIT_POS_COND_SEL) & MASK_COND_SEL);
+    out.cond_inv = (bool)((instruction >> BIT_POS_INV) & 1U);
+    out.dispatch = (out.cond_sel == (uint8_t)COND_DISPATCH);
 
     return out;
 }
+
+/**
+ * @brief Steps the sequential network of an instance to the next state.
+ *
+ * @param[in,out] state      State of the instance.
+ * @param[in]     condition  The condition value from the previous cycle.
+ * @return The new instruction containing requests for the system and condition
+ * selection for the next cycle.
+ */
+SeqNet_Out SeqNet_step(SeqNet_State *state, const uint8_t condition)
+{
+    return SeqNet_decode(SeqNet_step_raw(state, condition));
+}
+
+/**
+ * @brief Steps the sequential network to the next state.
+ *
+ * @param[in] condition  The condition value from the previous cycle.
+ * @return The new instruction containing requests for the system and condition
+ * selection for the next cycle.
+ */
+SeqNet_Out SeqNet_loop(const uint8_t condition)
+{
+    return SeqNet_step(&State, condition);
+}
+
+/**
+ * @brief Encodes the fields of an instruction back into the instruction word.
+ *
+ * @param[in] out  Decoded instruction.
+ * @return The 16-bit instruction word.
+ */
+uint16_t SeqNet_encode(const SeqNet_Out *out)
+{
+    uint16_t instruction = (uint16_t)out->jump_addr;
+
+    instruction |= out->req_move_up ? (uint16_t)FIELD_UP : 0U;
+    instruction |= out->req_move_down ? (uint16_t)FIELD_DOWN : 0U;
+    instruction |= out->req_door_state ? (uint16_t)FIELD_DOOR_OPEN : 0U;
+    instruction |= out->req_reset ? (uint16_t)FIELD_RESET : 0U;
+    instruction |= (uint16_t)((out->cond_sel & MASK_COND_SEL) << BIT_POS_COND_SEL);
+    instruction |= out->cond_inv ? (uint16_t)FIELD_INV : 0U;
+
+    return instruction;
+}
+
+/**
+ * @brief Reads the program counter.
+ *
+ * @return The address of the current instruction.
+ */
+uint8_t SeqNet_get_pc(void)
+{
+    return State.pc;
+}
@@ -0,0 +1,339 @@
+#include "telemetry.h"
+#include <errno.h>
+#include <string.h>
+
+/* Records are placed on separate cache lines, so readers of one car do not disturb another. */
+#define CACHE_LINE_SIZE  64U
+#define RECORD_SIZE      (((sizeof(Telemetry_Record) + CACHE_LINE_SIZE - 1U) / CACHE_LINE_SIZE) * CACHE_LINE_SIZE)
+
+/* The data is copied in whole words. */
+_Static_assert((sizeof(Telemetry_Data) % sizeof(uint32_t)) == 0U, "Telemetry_Data must consist of whole words");
+
+/* Bound of the reader retries while the writer keeps updating the record. */
+#define READ_RETRIES     64U
+
+/**
+ * @brief Calculates the address of a record.
+ *
+ * @param[in] telemetry  Handle of the segment.
+ * @param[in] record     Index of the record.
+ * @return Address of the record.
+ */
+static Telemetry_Record *record_at(const Telemetry *telemetry, const uint32_t record)
+{
+    uint8_t *records = (uint8_t *)telemetry->base + CACHE_LINE_SIZE;
+    return (Telemetry_Record *)(void *)(records + ((size_t)record * RECORD_SIZE));
+}
+
+/**
+ * @brief Publishes the state of a car.
+ *
+ * The sequence is made odd before and even again after the update. The data words and the
+ * published flag are written with relaxed atomic stores, ordered by the fences around them.
+ *
+ * @param[in,out] telemetry  Handle of the segment.
+ * @param[in]     record     Index of the record.
+ * @param[in]     data       State to publish.
+ */
+TELEMETRY_API void Telemetry_publish(Telemetry *telemetry, const uint32_t record, const Telemetry_Data *data)
+{
+    if ((telemetry->base == NULL) || (record >= telemetry->record_count))
+    {
+        return;
+    }
+
+    Telemetry_Record *target = record_at(telemetry, record);
+    const uint8_t *source = (const uint8_t *)data;
+
+    uint32_t seq = __atomic_load_n(&target->seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&target->seq, seq + 1U, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    /* Word-sized copies, so the loads forward from the caller's field stores. */
+    for (uint32_t i = 0U; i < TELEMETRY_DATA_WORDS; i++)
+    {
+        uint32_t word;
+        memcpy(&word, source + (i * sizeof(word)), sizeof(word));
+        __atomic_store_n(&target->words[i], word, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&target->published, 1U, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&target->seq, seq + 2U, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Reads a consistent snapshot of a record.
+ *
+ * @param[in]  telemetry  Handle of the segment.
+ * @param[in]  record     Index of the record.
+ * @param[out] data       Receives the snapshot.
+ * @return True if a consistent snapshot of a published record was taken.
+ */
+TELEMETRY_API bool Telemetry_read(const Telemetry *telemetry, const uint32_t record, Telemetry_Data *data)
+{
+    if ((telemetry->base == NULL) || (record >= telemetry->record_count))
+    {
+        return false;
+    }
+
+    Telemetry_Record *source = record_at(telemetry, record);
+    uint32_t words[TELEMETRY_DATA_WORDS];
+    uint32_t published;
+
+    for (uint32_t retry = 0U; retry < READ_RETRIES; retry++)
+    {
+        uint32_t seq_before = __atomic_load_n(&source->seq, __ATOMIC_ACQUIRE);
+        if ((seq_before & 1U) != 0U)
+        {
+            continue;
+        }
+
+        for (uint32_t i = 0U; i < TELEMETRY_DATA_WORDS; i++)
+        {
+            words[i] = __atomic_load_n(&source->words[i], __ATOMIC_RELAXED);
+        }
+        published = __atomic_load_n(&source->published, __ATOMIC_RELAXED);
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        uint32_t seq_after = __atomic_load_n(&source->seq, __ATOMIC_RELAXED);
+
+        if (seq_before == seq_after)
+        {
+            memcpy(data, words, sizeof(*data));
+            /* The sequence wraps, so it does not tell whether the record was ever published. */
+            return published != 0U;
+        }
+    }
+
+    return false;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Stores the name of the shared memory object in the handle.
+ *
+ * @param[out] telemetry  Handle of the segment.
+ * @param[in]  name       Name of the shared memory object.
+ * @return 0 on success, -ENAMETOOLONG if the name does not fit.
+ */
+static int set_name(Telemetry *telemetry, const char *name)
+{
+    size_t length = strlen(name);
+    if (length >= sizeof(telemetry->name))
+    {
+        return -ENAMETOOLONG;
+    }
+
+    memcpy(telemetry->name, name, length + 1U);
+    return 0;
+}
+
+/**
+ * @brief Creates a segment and maps it for writing.
+ *
+ * @param[out] telemetry     Handle of the segment.
+ * @param[in]  name          Name of the shared memory object.
+ * @param[in]  record_count  Number of records.
+ * @return 0 on success, -EEXIST if the segment exists, negative errno value otherwise.
+ */
+TELEMETRY_API int Telemetry_create(Telemetry *telemetry, const char *name, const uint32_t record_count)
+{
+    memset(telemetry, 0, sizeof(*telemetry));
+
+    int result = set_name(telemetry, name);
+    if (result != 0)
+    {
+        return result;
+    }
+
+    size_t size = CACHE_LINE_SIZE + ((size_t)record_count * RECORD_SIZE);
+
+    /* Never take over a segment of another writer, a stale one is removed with Telemetry_remove(). */
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0)
+    {
+        return -errno;
+    }
+
+    if (ftruncate(fd, (off_t)size) != 0)
+    {
+        result = -errno;
+        (void)close(fd);
+        (void)shm_unlink(name);
+        return result;
+    }
+
+    void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    result = (base == MAP_FAILED) ? -errno : 0;
+    (void)close(fd);
+    if (result != 0)
+    {
+        (void)shm_unlink(name);
+        return result;
+    }
+
+    /* The records are zero (never published) after ftruncate. The header is completed last. */
+    Telemetry_Header *header = (Telemetry_Header *)base;
+    header->version = TELEMETRY_VERSION;
+    header->record_count = record_count;
+    header->record_size = (uint32_t)RECORD_SIZE;
+    __atomic_store_n(&header->magic, (uint32_t)TELEMETRY_MAGIC, __ATOMIC_RELEASE);
+
+    telemetry->base = base;
+    telemetry->size = size;
+    telemetry->record_count = record_count;
+    telemetry->writer = true;
+
+    return 0;
+}
+
+/**
+ * @brief Maps an existing segment read-only.
+ *
+ * @param[out] telemetry  Handle of the segment.
+ * @param[in]  name       Name of the shared memory object.
+ * @return 0 on success, negative errno value otherwise.
+ */
+TELEMETRY_API int Telemetry_open(Telemetry *telemetry, const char *name)
+{
+    memset(telemetry, 0, sizeof(*telemetry));
+
+    int result = set_name(telemetry, name);
+    if (result != 0)
+    {
+        return result;
+    }
+
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0)
+    {
+        return -errno;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        result = -errno;
+        (void)close(fd);
+        return result;
+    }
+    if ((size_t)st.st_size < CACHE_LINE_SIZE)
+    {
+        (void)close(fd);
+        return -EPROTO;
+    }
+
+    void *base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    result = (base == MAP_FAILED) ? -errno : 0;
+    (void)close(fd);
+    if (result != 0)
+    {
+        return result;
+    }
+
+    const Telemetry_Header *header = (const Telemetry_Header *)base;
+    size_t needed = CACHE_LINE_SIZE + ((size_t)header->record_count * RECORD_SIZE);
+    if ((__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != TELEMETRY_MAGIC) ||
+        (header->version != TELEMETRY_VERSION) ||
+        (header->record_size != RECORD_SIZE) ||
+        (needed > (size_t)st.st_size))
+    {
+        (void)munmap(base, (size_t)st.st_size);
+        return -EPROTO;
+    }
+
+    telemetry->base = base;
+    telemetry->size = (size_t)st.st_size;
+    telemetry->record_count = header->record_count;
+    telemetry->writer = false;
+
+    return 0;
+}
+
+/**
+ * @brief Unmaps the segment.
+ *
+ * @param[in,out] telemetry  Handle of the segment.
+ */
+TELEMETRY_API void Telemetry_close(Telemetry *telemetry)
+{
+    if (telemetry->base != NULL)
+    {
+        (void)munmap(telemetry->base, telemetry->size);
+        if (telemetry->writer)
+        {
+            (void)shm_unlink(telemetry->name);
+        }
+    }
+
+    telemetry->base = NULL;
+    telemetry->size = 0U;
+    telemetry->record_count = 0U;
+}
+
+/**
+ * @brief Removes a segment left behind by a writer which did not close it.
+ *
+ * @param[in] name  Name of the shared memory object.
+ * @return 0 on success, negative errno value otherwise.
+ */
+TELEMETRY_API int Telemetry_remove(const char *name)
+{
+    return (shm_unlink(name) == 0) ? 0 : -errno;
+}
+
+#else
+
+/**
+ * @brief Shared memory is not available on this platform.
+ *
+ * @return -ENOSYS.
+ */
+TELEMETRY_API int Telemetry_create(Telemetry *telemetry, const char *name, const uint32_t record_count)
+{
+    (void)name;
+    (void)record_count;
+    memset(telemetry, 0, sizeof(*telemetry));
+    return -ENOSYS;
+}
+
+/**
+ * @brief Shared memory is not available on this platform.
+ *
+ * @return -ENOSYS.
+ */
+TELEMETRY_API int Telemetry_open(Telemetry *telemetry, const char *name)
+{
+    (void)name;
+    memset(telemetry, 0, sizeof(*telemetry));
+    return -ENOSYS;
+}
+
+/**
+ * @brief Nothing to unmap on this platform.
+ *
+ * @param[in,out] telemetry  Handle of the segment.
+ */
+TELEMETRY_API void Telemetry_close(Telemetry *telemetry)
+{
+    telemetry->base = NULL;
+}
+
+/**
+ * @brief Shared memory is not available on this platform.
+ *
+ * @return -ENOSYS.
+ */
+TELEMETRY_API int Telemetry_remove(const char *name)
+{
+    (void)name;
+    return -ENOSYS;
+}
+
+#endif
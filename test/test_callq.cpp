@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "callq.h"
+}
+
+class CallQTest : public ::testing::Test {
+public:
+    CallQ queue;
+
+protected:
+    void SetUp() override {
+        CallQ_init(&queue);
+    }
+};
+
+TEST_F(CallQTest, PostAndDrain) {
+    EXPECT_EQ(CallQ_drain(&queue), 0U);
+
+    EXPECT_TRUE(CallQ_post(&queue, 0U, nullptr));
+    EXPECT_TRUE(CallQ_post(&queue, 5U, nullptr));
+    EXPECT_TRUE(CallQ_post(&queue, 5U, nullptr));
+    EXPECT_TRUE(CallQ_post(&queue, CALLQ_MAX_FLOORS - 1U, nullptr));
+
+    EXPECT_EQ(CallQ_drain(&queue), (1UL << 0) | (1UL << 5) | (1UL << (CALLQ_MAX_FLOORS - 1U)));
+
+    /* The drain takes the calls over. */
+    EXPECT_EQ(CallQ_drain(&queue), 0U);
+}
+
+TEST_F(CallQTest, InvalidFloor) {
+    uint32_t ticket = 0U;
+
+    EXPECT_FALSE(CallQ_post(&queue, CALLQ_MAX_FLOORS, &ticket));
+    EXPECT_FALSE(CallQ_post(&queue, 255U, &ticket));
+    EXPECT_EQ(CallQ_drain(&queue), 0U);
+
+    /* Acknowledging an invalid floor is ignored. */
+    CallQ_ack(&queue, CALLQ_MAX_FLOORS);
+    EXPECT_FALSE(CallQ_is_served(&queue, CALLQ_MAX_FLOORS, ticket));
+}
+
+TEST_F(CallQTest, AckServesTicket) {
+    uint32_t ticket_3 = 0U;
+    uint32_t ticket_4 = 0U;
+
+    ASSERT_TRUE(CallQ_post(&queue, 3U, &ticket_3));
+    ASSERT_TRUE(CallQ_post(&queue, 4U, &ticket_4));
+    EXPECT_FALSE(CallQ_is_served(&queue, 3U, ticket_3));
+    EXPECT_FALSE(CallQ_is_served(&queue, 4U, ticket_4));
+
+    EXPECT_EQ(CallQ_drain(&queue), (1UL << 3) | (1UL << 4));
+    CallQ_ack(&queue, 3U);
+
+    EXPECT_TRUE(CallQ_is_served(&queue, 3U, ticket_3));
+    EXPECT_FALSE(CallQ_is_served(&queue, 4U, ticket_4));
+
+    /* A new call on the served floor needs a new service. */
+    uint32_t ticket_3b = 0U;
+    ASSERT_TRUE(CallQ_post(&queue, 3U, &ticket_3b));
+    EXPECT_FALSE(CallQ_is_served(&queue, 3U, ticket_3b));
+}
+
+TEST_F(CallQTest, AckServesOnlyDrainedCalls) {
+    /* A call posted between the drain and the ack of an earlier call on its floor is not served by
+     * that ack, only by the one after the next drain. */
+    uint32_t ticket_early = 0U;
+    uint32_t ticket_late = 0U;
+
+    ASSERT_TRUE(CallQ_post(&queue, 2U, &ticket_early));
+    EXPECT_EQ(CallQ_drain(&queue), 1UL << 2);
+    ASSERT_TRUE(CallQ_post(&queue, 2U, &ticket_late));
+    CallQ_ack(&queue, 2U);
+
+    EXPECT_TRUE(CallQ_is_served(&queue, 2U, ticket_early));
+    EXPECT_FALSE(CallQ_is_served(&queue, 2U, ticket_late));
+
+    EXPECT_EQ(CallQ_drain(&queue), 1UL << 2);
+    EXPECT_FALSE(CallQ_is_served(&queue, 2U, ticket_late));
+    CallQ_ack(&queue, 2U);
+    EXPECT_TRUE(CallQ_is_served(&queue, 2U, ticket_late));
+}
+
+TEST_F(CallQTest, CallsBeforeDrainShareService) {
+    /* Calls of a floor posted before the same drain are taken over and served together. */
+    uint32_t ticket_a = 0U;
+    uint32_t ticket_b = 0U;
+
+    ASSERT_TRUE(CallQ_post(&queue, 6U, &ticket_a));
+    ASSERT_TRUE(CallQ_post(&queue, 6U, &ticket_b));
+    EXPECT_EQ(ticket_a, ticket_b);
+
+    EXPECT_EQ(CallQ_drain(&queue), 1UL << 6);
+    EXPECT_EQ(CallQ_drain(&queue), 0U);
+    CallQ_ack(&queue, 6U);
+    EXPECT_TRUE(CallQ_is_served(&queue, 6U, ticket_a));
+    EXPECT_TRUE(CallQ_is_served(&queue, 6U, ticket_b));
+}
+
+TEST_F(CallQTest, ConcurrentProducersDelayedAck) {
+    /* Like the simulator, the control loop serves a drained call in a later cycle, while new
+     * calls on the floor keep coming in. A ticket must not be served before a drain took the call
+     * over: every producer records the drains of its floor before posting, the loop the drains of
+     * the floor at each ack. */
+    constexpr unsigned kProducers = 4U;
+    constexpr unsigned kCallsPerProducer = 2000U;
+    constexpr uint8_t kFloors = 2U;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+
+    std::atomic<unsigned> finished {0U};
+    std::atomic<unsigned> early {0U};
+    std::atomic<unsigned> served_calls {0U};
+    std::atomic<uint32_t> drains[kFloors] {};
+    std::atomic<uint32_t> acked[kFloors] {};
+    std::vector<std::thread> producers;
+
+    for (unsigned p = 0U; p < kProducers; p++) {
+        producers.emplace_back([&, p]() {
+            for (unsigned i = 0U; i < kCallsPerProducer; i++) {
+                const uint8_t floor = (uint8_t)((p + i) % kFloors);
+                /* Staggered, so calls come in while the floor is pending. */
+                std::this_thread::sleep_for(std::chrono::microseconds((p * 37U + i * 11U) % 50U));
+                const uint32_t drains_before = drains[floor].load();
+                uint32_t ticket = 0U;
+                EXPECT_TRUE(CallQ_post(&queue, floor, &ticket));
+                while (!CallQ_is_served(&queue, floor, ticket)) {
+                    if (std::chrono::steady_clock::now() > deadline) {
+                        finished++;
+                        return;
+                    }
+                    std::this_thread::yield();
+                }
+                if (acked[floor].load() <= drains_before) {
+                    early++;
+                }
+                served_calls++;
+            }
+            finished++;
+        });
+    }
+
+    /* The control loop: serve a pending floor in the cycle after taking it over, then drain. Calls
+     * posted since the previous drain are still in the queue at the ack. */
+    unsigned age[kFloors] = {};
+    bool pending[kFloors] = {};
+    while (finished.load() < kProducers) {
+        for (uint8_t floor = 0U; floor < kFloors; floor++) {
+            if (pending[floor] && (++age[floor] > 1U)) {
+                pending[floor] = false;
+                acked[floor] = drains[floor].load();
+                CallQ_ack(&queue, floor);
+            }
+        }
+        uint32_t posted = CallQ_drain(&queue);
+        for (uint8_t floor = 0U; floor < kFloors; floor++) {
+            if ((posted & (1UL << floor)) != 0U) {
+                drains[floor]++;
+                if (!pending[floor]) {
+                    pending[floor] = true;
+                    age[floor] = 0U;
+                }
+            }
+        }
+        std::this_thread::yield();
+    }
+
+    for (auto &producer : producers) {
+        producer.join();
+    }
+
+    EXPECT_EQ(early.load(), 0U);
+    EXPECT_EQ(served_calls.load(), kProducers * kCallsPerProducer);
+}
+
+TEST_F(CallQTest, ConcurrentProducers) {
+    /* Every producer waits for the service of its call before posting the next one,
+     * so a lost call stalls its producer until the deadline. */
+    constexpr unsigned kProducers = 4U;
+    constexpr unsigned kCallsPerProducer = 2000U;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+
+    std::atomic<unsigned> finished {0U};
+    std::atomic<unsigned> served_calls {0U};
+    std::vector<std::thread> producers;
+
+    for (unsigned p = 0U; p < kProducers; p++) {
+        producers.emplace_back([&, p]() {
+            for (unsigned i = 0U; i < kCallsPerProducer; i++) {
+                const uint8_t floor = (uint8_t)((p * 7U + i) % CALLQ_MAX_FLOORS);
+                uint32_t ticket = 0U;
+                EXPECT_TRUE(CallQ_post(&queue, floor, &ticket));
+                while (!CallQ_is_served(&queue, floor, ticket)) {
+                    if (std::chrono::steady_clock::now() > deadline) {
+                        finished++;
+                        return;
+                    }
+                    std::this_thread::yield();
+                }
+                served_calls++;
+            }
+            finished++;
+        });
+    }
+
+    /* The control loop: drain once per cycle and serve everything it took over. */
+    while (finished.load() < kProducers) {
+        uint32_t posted = CallQ_drain(&queue);
+        for (uint8_t floor = 0U; floor < CALLQ_MAX_FLOORS; floor++) {
+            if ((posted & (1UL << floor)) != 0U) {
+                CallQ_ack(&queue, floor);
+            }
+        }
+        std::this_thread::yield();
+    }
+
+    for (auto &producer : producers) {
+        producer.join();
+    }
+
+    EXPECT_EQ(served_calls.load(), kProducers * kCallsPerProducer);
+}
@@ -199,3 +199,134 @@ TEST_F(CondSelTest, InvalidIndex) {
     EXPECT_EQ(CondSel_calc(false, 8, inputs),false);
     EXPECT_EQ(CondSel_calc(false, 255, inputs),false);
 }
+
+TEST_F(CondSelTest, Vector_PositionsOk) {
+    inputs = {true, false, true, true, false};
+
+    ON_CALL(mock_posdet, PosDet_is_elevator_position_ok()).WillByDefault(Return(true));
+    ON_CALL(mock_posdet, PosDet_is_door_position_ok()).WillByDefault(Return(true));
+
+    EXPECT_CALL(mock_posdet, PosDet_is_elevator_position_ok()).Times(1);
+    EXPECT_CALL(mock_posdet, PosDet_is_door_position_ok()).Times(1);
+    EXPECT_EQ(CondSel_vector(inputs), CONDSEL_VEC_BELOW | CONDSEL_VEC_ABOVE | CONDSEL_VEC_DOOR_CLOSED);
+
+    inputs = {false, true, false, false, true};
+    EXPECT_CALL(mock_posdet, PosDet_is_elevator_position_ok()).Times(1);
+    EXPECT_CALL(mock_posdet, PosDet_is_door_position_ok()).Times(1);
+    EXPECT_EQ(CondSel_vector(inputs), CONDSEL_VEC_SAME);
+}
+
+TEST_F(CondSelTest, Vector_PositionsNotOk) {
+    inputs = {true, true, true, true, false};
+
+    /* Call bits are gated by the elevator position. */
+    ON_CALL(mock_posdet, PosDet_is_elevator_position_ok()).WillByDefault(Return(false));
+    ON_CALL(mock_posdet, PosDet_is_door_position_ok()).WillByDefault(Return(true));
+    EXPECT_EQ(CondSel_vector(inputs), CONDSEL_VEC_DOOR_CLOSED);
+
+    /* The door bit is gated by the door position. */
+    ON_CALL(mock_posdet, PosDet_is_elevator_position_ok()).WillByDefault(Return(true));
+    ON_CALL(mock_posdet, PosDet_is_door_position_ok()).WillByDefault(Return(false));
+    EXPECT_EQ(CondSel_vector(inputs), CONDSEL_VEC_BELOW | CONDSEL_VEC_SAME | CONDSEL_VEC_ABOVE);
+}
+
+TEST_F(CondSelTest, Eval) {
+    inputs = {false, false, true, false, true};
+
+    ON_CALL(mock_posdet, PosDet_is_elevator_position_ok()).WillByDefault(Return(true));
+    ON_CALL(mock_posdet, PosDet_is_door_position_ok()).WillByDefault(Return(true));
+
+    /* Boolean conditions behave like CondSel_calc. */
+    EXPECT_EQ(CondSel_eval(false, 3, inputs), 1U);
+    EXPECT_EQ(CondSel_eval(true, 3, inputs), 0U);
+    EXPECT_EQ(CondSel_eval(true, 7, inputs), 1U);
+
+    /* The dispatch index returns the packed vector, the inversion does not apply to it. */
+    EXPECT_EQ(CondSel_eval(false, CONDSEL_INDEX_DISPATCH, inputs), CONDSEL_VEC_ABOVE);
+    EXPECT_EQ(CondSel_eval(true, CONDSEL_INDEX_DISPATCH, inputs), CONDSEL_VEC_ABOVE);
+
+    /* As a single boolean the packed vector always reads as false. */
+    EXPECT_EQ(CondSel_calc(false, CONDSEL_INDEX_DISPATCH, inputs), false);
+}
+
+/* Function table trampolines, the context is the mock of the car. */
+static bool mock_elevator_position_ok(void *context) {
+    return static_cast<MockPosDet *>(context)->PosDet_is_elevator_position_ok();
+}
+
+static bool mock_door_position_ok(void *context) {
+    return static_cast<MockPosDet *>(context)->PosDet_is_door_position_ok();
+}
+
+TEST_F(CondSelTest, Ops_PerInstanceSensors) {
+    /* Two cars with their own sensors, the global binding is not used. */
+    NiceMock<MockPosDet> car_a;
+    NiceMock<MockPosDet> car_b;
+    const PosDet_Ops posdet_a = {mock_elevator_position_ok, mock_door_position_ok, &car_a};
+    const PosDet_Ops posdet_b = {mock_elevator_position_ok, mock_door_position_ok, &car_b};
+
+    ON_CALL(car_a, PosDet_is_elevator_position_ok()).WillByDefault(Return(true));
+    ON_CALL(car_a, PosDet_is_door_position_ok()).WillByDefault(Return(true));
+    ON_CALL(car_b, PosDet_is_elevator_position_ok()).WillByDefault(Return(false));
+    ON_CALL(car_b, PosDet_is_door_position_ok()).WillByDefault(Return(false));
+    EXPECT_CALL(mock_posdet, PosDet_is_elevator_position_ok()).Times(0);
+    EXPECT_CALL(mock_posdet, PosDet_is_door_position_ok()).Times(0);
+
+    inputs = {false, false, true, true, false};
+
+    EXPECT_CALL(car_a, PosDet_is_elevator_position_ok()).Times(1);
+    EXPECT_CALL(car_b, PosDet_is_elevator_position_ok()).Times(1);
+    EXPECT_EQ(CondSel_calc_ops(&posdet_a, false, 3, inputs), true);
+    EXPECT_EQ(CondSel_calc_ops(&posdet_b, false, 3, inputs), false);
+
+    EXPECT_CALL(car_a, PosDet_is_door_position_ok()).Times(1);
+    EXPECT_CALL(car_b, PosDet_is_door_position_ok()).Times(1);
+    EXPECT_EQ(CondSel_calc_ops(&posdet_a, true, 4, inputs), false);
+    EXPECT_EQ(CondSel_calc_ops(&posdet_b, true, 4, inputs), true);
+}
+
+TEST_F(CondSelTest, Ops_VectorAndEval) {
+    NiceMock<MockPosDet> car;
+    const PosDet_Ops posdet = {mock_elevator_position_ok, mock_door_position_ok, &car};
+
+    ON_CALL(car, PosDet_is_elevator_position_ok()).WillByDefault(Return(false));
+    ON_CALL(car, PosDet_is_door_position_ok()).WillByDefault(Return(true));
+    EXPECT_CALL(mock_posdet, PosDet_is_elevator_position_ok()).Times(0);
+    EXPECT_CALL(mock_posdet, PosDet_is_door_position_ok()).Times(0);
+
+    inputs = {true, true, true, true, false};
+
+    EXPECT_EQ(CondSel_vector_ops(&posdet, inputs), CONDSEL_VEC_DOOR_CLOSED);
+    EXPECT_EQ(CondSel_eval_ops(&posdet, false, CONDSEL_INDEX_DISPATCH, inputs), CONDSEL_VEC_DOOR_CLOSED);
+    EXPECT_EQ(CondSel_eval_ops(&posdet, false, 1, inputs), 0U);
+    EXPECT_EQ(CondSel_eval_ops(&posdet, false, 4, inputs), 1U);
+}
+
+TEST_F(CondSelTest, Packed_MatchesUnpacked) {
+    /* Every sensor word, condition index and inversion gives the same value as the
+     * unpacked evaluation with the same position check results. */
+    for (uint32_t sensors = 0U; sensors < 128U; sensors++) {
+        CondSel_In values {
+            (sensors & CONDSEL_IN_BELOW) != 0U,
+            (sensors & CONDSEL_IN_SAME) != 0U,
+            (sensors & CONDSEL_IN_ABOVE) != 0U,
+            (sensors & CONDSEL_IN_DOOR_CLOSED) != 0U,
+            (sensors & CONDSEL_IN_DOOR_OPEN) != 0U,
+        };
+        bool elevator_ok = (sensors & CONDSEL_IN_ELEVATOR_POS_OK) != 0U;
+        bool door_ok = (sensors & CONDSEL_IN_DOOR_POS_OK) != 0U;
+
+        ASSERT_EQ(CondSel_pack(values, elevator_ok, door_ok), sensors);
+
+        ON_CALL(mock_posdet, PosDet_is_elevator_position_ok()).WillByDefault(Return(elevator_ok));
+        ON_CALL(mock_posdet, PosDet_is_door_position_ok()).WillByDefault(Return(door_ok));
+
+        for (uint32_t index = 0U; index < 10U; index++) {
+            for (bool invert : {false, true}) {
+                ASSERT_EQ(CondSel_eval_packed(invert, (uint8_t)index, (uint8_t)sensors),
+                          CondSel_eval(invert, (uint8_t)index, values))
+                    << "sensors=" << sensors << " index=" << index << " invert=" << invert;
+            }
+        }
+    }
+}
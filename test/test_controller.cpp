@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "controller.h"
+#include "condsel.h"
+}
+
+TEST(ControllerTest, AccessorsMatchDecode) {
+    for (uint32_t word = 0U; word <= 0xFFFFU; word++) {
+        SeqNet_Out out = SeqNet_decode((uint16_t)word);
+        ASSERT_EQ(SEQNET_JUMP_ADDR(word), out.jump_addr);
+        ASSERT_EQ(SEQNET_MOVE_UP(word), out.req_move_up);
+        ASSERT_EQ(SEQNET_MOVE_DOWN(word), out.req_move_down);
+        ASSERT_EQ(SEQNET_DOOR_OPEN(word), out.req_door_state);
+        ASSERT_EQ(SEQNET_RESET(word), out.req_reset);
+        ASSERT_EQ(SEQNET_COND_SEL(word), out.cond_sel);
+        ASSERT_EQ(SEQNET_COND_INV(word), out.cond_inv);
+        ASSERT_EQ(SEQNET_REQUESTS(word), (out.req_move_up ? 1U : 0U) | (out.req_move_down ? 2U : 0U) |
+                                         (out.req_door_state ? 4U : 0U) | (out.req_reset ? 8U : 0U));
+    }
+}
+
+TEST(ControllerTest, PowerUpIgnoresSensors) {
+    Controller a;
+    Controller b;
+    Controller_init(&a);
+    Controller_init(&b);
+
+    EXPECT_EQ(a.instruction, SEQNET_POWER_UP_INSTRUCTION);
+    EXPECT_EQ(Controller_step(&a, 0x00U), Controller_step(&b, 0x7FU));
+    EXPECT_EQ(a.state.pc, b.state.pc);
+}
+
+TEST(ControllerTest, MatchesSeparateStepAndEvaluation) {
+    Controller controller;
+    Controller_init(&controller);
+    SeqNet_init();
+
+    SeqNet_Out out = {};
+    uint32_t seed = 7U;
+    for (uint32_t cycle = 0U; cycle < 100000U; cycle++) {
+        seed = (seed * 1103515245U) + 12345U;
+        uint8_t sensors = (uint8_t)((seed >> 16) & 0x7FU);
+
+        uint8_t condition = (cycle == 0U) ? 0U : CondSel_eval_packed(out.cond_inv, out.cond_sel, sensors);
+        out = SeqNet_loop(condition);
+
+        ASSERT_EQ(Controller_step(&controller, sensors), SeqNet_encode(&out)) << "cycle " << cycle;
+        ASSERT_EQ(controller.state.pc, SeqNet_get_pc());
+    }
+}
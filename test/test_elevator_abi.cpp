@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+extern "C" {
+#include "elevator_abi.h"
+#include "condsel.h"
+#include "seqnet.h"
+}
+
+/* Sensor words of the test pattern. */
+static const uint8_t kPositionsOk = CONDSEL_IN_ELEVATOR_POS_OK | CONDSEL_IN_DOOR_POS_OK;
+
+/* Pseudo-random sensor word, the same for the batch and the reference run. */
+static uint8_t sensor_word(uint32_t cycle, uint32_t car) {
+    uint32_t x = (cycle / 7U) * 2654435761U + car * 40503U;
+    return (uint8_t)(((x >> 13) & 0x1FU) | kPositionsOk);
+}
+
+TEST(ElevatorAbiTest, Version) {
+    EXPECT_EQ(elev_abi_version(), (ELEV_ABI_VERSION_MAJOR << 16) | ELEV_ABI_VERSION_MINOR);
+}
+
+TEST(ElevatorAbiTest, InvalidArguments) {
+    EXPECT_EQ(elev_batch_create(0U), nullptr);
+    EXPECT_EQ(elev_batch_count(nullptr), 0U);
+    EXPECT_EQ(elev_batch_reset(nullptr), ELEV_ERR_INVALID);
+    EXPECT_EQ(elev_batch_step(nullptr, nullptr, nullptr, 1U), ELEV_ERR_INVALID);
+    elev_batch_destroy(nullptr);
+
+    ElevBatch *batch = elev_batch_create(2U);
+    ASSERT_NE(batch, nullptr);
+    EXPECT_EQ(elev_batch_count(batch), 2U);
+    EXPECT_EQ(elev_batch_step(batch, nullptr, nullptr, 1U), ELEV_ERR_INVALID);
+    EXPECT_EQ(elev_batch_step(batch, nullptr, nullptr, 0U), ELEV_OK);
+    elev_batch_destroy(batch);
+}
+
+TEST(ElevatorAbiTest, BatchMatchesSingleController) {
+    /* Every car of the batch behaves like the default instance driven the emulator's way. */
+    constexpr uint32_t kCars = 17U;
+    constexpr uint32_t kCycles = 300U;
+
+    std::vector<uint8_t> sensors(kCars * kCycles);
+    std::vector<uint16_t> outputs(kCars * kCycles);
+    for (uint32_t cycle = 0U; cycle < kCycles; cycle++) {
+        for (uint32_t car = 0U; car < kCars; car++) {
+            sensors[cycle * kCars + car] = sensor_word(cycle, car);
+        }
+    }
+
+    ElevBatch *batch = elev_batch_create(kCars);
+    ASSERT_NE(batch, nullptr);
+
+    /* Step in two calls of different length, state carries over between calls. */
+    ASSERT_EQ(elev_batch_step(batch, sensors.data(), outputs.data(), 100U), ELEV_OK);
+    ASSERT_EQ(elev_batch_step(batch, sensors.data() + 100U * kCars, outputs.data() + 100U * kCars, kCycles - 100U), ELEV_OK);
+
+    for (uint32_t car = 0U; car < kCars; car++) {
+        uint8_t condition = 0U;
+        SeqNet_init();
+        for (uint32_t cycle = 0U; cycle < kCycles; cycle++) {
+            if (cycle > 0U) {
+                SeqNet_Out previous = SeqNet_decode(outputs[(cycle - 1U) * kCars + car]);
+                condition = CondSel_eval_packed(previous.cond_inv, previous.cond_sel, sensors[cycle * kCars + car]);
+            }
+            SeqNet_Out out = SeqNet_loop(condition);
+            ASSERT_EQ(SeqNet_encode(&out), outputs[cycle * kCars + car]) << "car=" << car << " cycle=" << cycle;
+        }
+    }
+
+    /* After a reset the batch starts over. */
+    std::vector<uint16_t> again(kCars * kCycles);
+    ASSERT_EQ(elev_batch_reset(batch), ELEV_OK);
+    ASSERT_EQ(elev_batch_step(batch, sensors.data(), again.data(), kCycles), ELEV_OK);
+    EXPECT_EQ(again, outputs);
+
+    elev_batch_destroy(batch);
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <dlfcn.h>
+#include <vector>
+
+extern "C" {
+#include "elevator_abi.h"
+#include "condsel.h"
+}
+
+/* Runs against libelevator itself, so the controller is only reachable through the exported ABI. */
+
+/* Sensor words: both positions checked, door closed, with or without a call above. */
+static const uint8_t kIdle = CONDSEL_IN_ELEVATOR_POS_OK | CONDSEL_IN_DOOR_POS_OK | CONDSEL_IN_DOOR_CLOSED;
+static const uint8_t kCallAbove = kIdle | CONDSEL_IN_ABOVE;
+
+TEST(ElevatorSharedTest, ExportsOnlyTheAbi) {
+    void *library = dlopen(ELEVATOR_SHARED_FILE, RTLD_NOW | RTLD_NOLOAD);
+    ASSERT_NE(library, nullptr) << dlerror();
+
+    EXPECT_NE(dlsym(library, "elev_abi_version"), nullptr);
+    EXPECT_NE(dlsym(library, "elev_batch_create"), nullptr);
+    EXPECT_NE(dlsym(library, "elev_batch_destroy"), nullptr);
+    EXPECT_NE(dlsym(library, "elev_batch_count"), nullptr);
+    EXPECT_NE(dlsym(library, "elev_batch_reset"), nullptr);
+    EXPECT_NE(dlsym(library, "elev_batch_step"), nullptr);
+
+    /* The controller inside is hidden. */
+    EXPECT_EQ(dlsym(library, "Controller_step"), nullptr);
+    EXPECT_EQ(dlsym(library, "SeqNet_step_raw"), nullptr);
+    EXPECT_EQ(dlsym(library, "CondSel_eval_packed"), nullptr);
+
+    dlclose(library);
+}
+
+TEST(ElevatorSharedTest, Version) {
+    EXPECT_EQ(elev_abi_version(), (ELEV_ABI_VERSION_MAJOR << 16) | ELEV_ABI_VERSION_MINOR);
+}
+
+TEST(ElevatorSharedTest, CallAboveMovesUp) {
+    /* Every car of a batch with a call above requests to move up, never down, and all cars agree. */
+    constexpr uint32_t kCars = 5U;
+    constexpr uint32_t kCycles = 20U;
+
+    std::vector<uint8_t> sensors(kCars * kCycles, kCallAbove);
+    std::vector<uint16_t> outputs(kCars * kCycles);
+    for (uint32_t car = 0U; car < kCars; car++) {
+        sensors[car] = kIdle;
+    }
+
+    ElevBatch *batch = elev_batch_create(kCars);
+    ASSERT_NE(batch, nullptr);
+    EXPECT_EQ(elev_batch_count(batch), kCars);
+    ASSERT_EQ(elev_batch_step(batch, sensors.data(), outputs.data(), kCycles), ELEV_OK);
+
+    bool moved_up = false;
+    for (uint32_t cycle = 0U; cycle < kCycles; cycle++) {
+        for (uint32_t car = 0U; car < kCars; car++) {
+            uint16_t output = outputs[cycle * kCars + car];
+            ASSERT_EQ(output, outputs[cycle * kCars]) << "car=" << car << " cycle=" << cycle;
+            EXPECT_EQ(output & ELEV_OUT_MOVE_DOWN, 0U);
+            moved_up = moved_up || ((output & ELEV_OUT_MOVE_UP) != 0U);
+        }
+    }
+    EXPECT_TRUE(moved_up);
+
+    /* After a reset the batch starts over. */
+    std::vector<uint16_t> again(kCars * kCycles);
+    ASSERT_EQ(elev_batch_reset(batch), ELEV_OK);
+    ASSERT_EQ(elev_batch_step(batch, sensors.data(), again.data(), kCycles), ELEV_OK);
+    EXPECT_EQ(again, outputs);
+
+    elev_batch_destroy(batch);
+}
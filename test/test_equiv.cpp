@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include <cerrno>
+#include <vector>
+
+extern "C" {
+#include "equiv.h"
+#include "seqnet.h"
+}
+
+/* Instruction fields, as documented in seqnet.h. */
+static const uint16_t kUp = 1U << 8;
+static const uint16_t kInv = 1U << 15;
+static const uint16_t kAlways = kInv | (7U << 12);
+static uint16_t cond(uint16_t index) { return (uint16_t)(index << 12); }
+
+/* Addresses of the built-in program. */
+static const uint8_t kIdle = 1U;
+static const uint8_t kChooseDir = 6U;
+static const uint8_t kMoveUp = 7U;
+static const uint8_t kMoveDown = 9U;
+static const uint8_t kArrived = 11U;
+
+/* Words of the built-in program, states and jump tables. */
+static const uint8_t kProgramEnd = 21U;
+
+class EquivTest : public ::testing::Test {
+public:
+    std::vector<uint16_t> reference;
+    std::vector<uint16_t> candidate;
+    Equiv_Result result {};
+
+protected:
+    void SetUp() override {
+        const uint16_t *program = SeqNet_program();
+        reference.assign(program, program + SEQNET_PROG_MEM_SIZE);
+        candidate = reference;
+    }
+
+    void TearDown() override {
+        Equiv_free(&result);
+    }
+
+    bool check(uint8_t stretch, uint8_t threads = 4U) {
+        Equiv_free(&result);
+        Equiv_Config config {stretch, threads};
+        EXPECT_EQ(Equiv_check(reference.data(), candidate.data(), &config, &result), 0);
+        return result.equivalent;
+    }
+
+    /* Replays the counterexample, only its last step may differ. */
+    void expect_shortest_difference(uint8_t stretch) {
+        ASSERT_GT(result.length, 0U);
+        Equiv_Machine a;
+        Equiv_Machine b;
+        Equiv_init(&a);
+        Equiv_init(&b);
+
+        for (uint32_t step = 0U; step < result.length; step++) {
+            uint8_t output_a;
+            uint8_t output_b;
+            uint8_t cycles_a = Equiv_react(reference.data(), &a, result.trace[step], stretch, &output_a);
+            uint8_t cycles_b = Equiv_react(candidate.data(), &b, result.trace[step], stretch, &output_b);
+            bool same = (output_a == output_b) && ((cycles_a == 0U) == (cycles_b == 0U));
+            EXPECT_EQ(same, step + 1U < result.length) << "step " << step;
+        }
+    }
+};
+
+TEST_F(EquivTest, InvalidArguments) {
+    Equiv_Config config {0U, EQUIV_MAX_THREADS + 1U};
+    EXPECT_EQ(Equiv_check(reference.data(), candidate.data(), &config, &result), -EINVAL);
+    config.threads = 1U;
+    EXPECT_EQ(Equiv_check(nullptr, candidate.data(), &config, &result), -EINVAL);
+}
+
+TEST_F(EquivTest, ProgramIsEquivalentToItself) {
+    EXPECT_TRUE(check(0U));
+    EXPECT_EQ(result.length, 0U);
+    EXPECT_GT(result.states, 1U);
+    EXPECT_TRUE(check(16U));
+}
+
+TEST_F(EquivTest, RelocatedProgramIsEquivalent) {
+    /* Move the states from CLOSE_DOOR on up by 100 words, jump addresses follow. */
+    const uint8_t offset = 100U;
+    const uint8_t moved = 4U;
+    auto relocate = [&](uint16_t word) -> uint16_t {
+        return ((word & 0xFFU) >= moved) ? (uint16_t)(word + offset) : word;
+    };
+
+    candidate.assign(SEQNET_PROG_MEM_SIZE, 0U);
+    for (uint8_t address = 0U; address < kProgramEnd; address++) {
+        candidate[(address >= moved) ? (address + offset) : address] = relocate(reference[address]);
+    }
+    EXPECT_TRUE(check(0U));
+}
+
+TEST_F(EquivTest, PowerUpFallsThrough) {
+    /* The power-up cycle runs with condition 0, so PC 1 follows PC 0 whatever its jump address is.
+     * An INIT that jumps to IDLE at another address is not enough. */
+    const uint8_t idle = 50U;
+    candidate[0] = (uint16_t)(kAlways | idle);
+    for (uint8_t word = 0U; word < 3U; word++) {
+        uint16_t instruction = reference[kIdle + word];
+        candidate[idle + word] = ((instruction & 0xFFU) == kIdle) ? (uint16_t)((instruction & 0xFF00U) | idle) : instruction;
+        candidate[kIdle + word] = 0U;
+    }
+
+    EXPECT_FALSE(check(0U));
+    EXPECT_EQ(result.length, 1U);
+    expect_shortest_difference(0U);
+}
+
+TEST_F(EquivTest, ChangedRequestIsFound) {
+    /* MOVE_UP no longer requests the movement. */
+    candidate[kMoveUp + 1U] &= (uint16_t)~kUp;
+
+    EXPECT_FALSE(check(0U));
+    expect_shortest_difference(0U);
+    EXPECT_FALSE(check(16U));
+    expect_shortest_difference(16U);
+}
+
+TEST_F(EquivTest, CheckChainNeedsStretching) {
+    /* CHOOSE_DIR as the chain of single checks it replaced, in free words behind the program. */
+    const uint8_t chain = 40U;
+    candidate[kChooseDir] = (uint16_t)(kAlways | chain);
+    candidate[chain] = (uint16_t)(cond(3U) | kMoveUp);
+    candidate[chain + 1U] = (uint16_t)(cond(1U) | kMoveDown);
+    candidate[chain + 2U] = (uint16_t)(cond(2U) | kArrived);
+    candidate[chain + 3U] = (uint16_t)(kAlways | kIdle);
+
+    /* In lockstep the extra cycles are visible. */
+    EXPECT_FALSE(check(0U));
+    expect_shortest_difference(0U);
+
+    /* With the inputs held, the decisions are the same. */
+    EXPECT_TRUE(check(8U));
+
+    /* Unless the window is too short for the longest chain. */
+    EXPECT_FALSE(check(4U));
+    expect_shortest_difference(4U);
+}
+
+TEST_F(EquivTest, ResultDoesNotDependOnThreads) {
+    candidate[kArrived] &= (uint16_t)~(1U << 11);
+
+    EXPECT_FALSE(check(0U, 1U));
+    uint32_t states = result.states;
+    std::vector<uint8_t> trace(result.trace, result.trace + result.length);
+
+    for (uint8_t threads : {2U, 7U, 16U}) {
+        EXPECT_FALSE(check(0U, threads));
+        EXPECT_EQ(result.states, states);
+        EXPECT_EQ(std::vector<uint8_t>(result.trace, result.trace + result.length), trace);
+    }
+}
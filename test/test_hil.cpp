@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include <cerrno>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+extern "C" {
+#include "hil.h"
+#include "elevator_abi.h"
+}
+
+/* Short timeouts, a broken test fails fast. */
+static constexpr int kTimeoutMs = 2000;
+
+class HilTest : public ::testing::TestWithParam<const char *> {
+protected:
+    /* Address of the transport under test, unique per process so parallel test runs do not collide. */
+    std::string address(const char *suffix) const {
+        std::string prefix = GetParam();
+        std::string name = "/elevator_hil_test_" + std::to_string(getpid()) + "_" + suffix;
+        return (prefix == "unix:") ? ("unix:/tmp" + name) : (prefix + name);
+    }
+};
+
+/* Runs a gateway for one session on a thread. */
+struct Gateway {
+    HIL_Link link {};
+    HIL_Stats stats {};
+    int serve_result = -1;
+    int run_result = -1;
+    std::thread thread;
+
+    explicit Gateway(const std::string &address) {
+        thread = std::thread([this, address] {
+            serve_result = HIL_serve(&link, address.c_str(), kTimeoutMs);
+            if (serve_result == 0) {
+                run_result = HIL_run_gateway(&link, &stats);
+                HIL_close(&link);
+            }
+        });
+    }
+
+    void join() {
+        thread.join();
+    }
+};
+
+TEST_P(HilTest, GatewayMatchesLocalBatch) {
+    constexpr uint32_t kCars = 37U;
+    constexpr uint64_t kTicks = 2000U;
+    Gateway gateway(address("match"));
+
+    HIL_Link link;
+    HIL_Stats stats;
+    ASSERT_EQ(HIL_connect(&link, address("match").c_str(), kTimeoutMs), 0);
+    ASSERT_EQ(HIL_hello(&link, kCars, &stats), 0);
+
+    ElevBatch *local = elev_batch_create(kCars);
+    uint8_t sensors[kCars];
+    uint16_t remote_out[kCars];
+    uint16_t local_out[kCars];
+    uint32_t seed = 7U;
+
+    for (uint64_t tick = 0U; tick < kTicks; tick++) {
+        for (uint32_t car = 0U; car < kCars; car++) {
+            seed = (seed * 1103515245U) + 12345U;
+            sensors[car] = (uint8_t)((seed >> 16) & 0x7FU);
+        }
+        ASSERT_EQ(HIL_exchange(&link, tick, sensors, remote_out, kCars, &stats), 0);
+        ASSERT_EQ(elev_batch_step(local, sensors, local_out, 1U), ELEV_OK);
+        for (uint32_t car = 0U; car < kCars; car++) {
+            ASSERT_EQ(remote_out[car], local_out[car]) << "tick " << tick << " car " << car;
+        }
+    }
+
+    EXPECT_EQ(HIL_bye(&link), 0);
+    gateway.join();
+    HIL_close(&link);
+    elev_batch_destroy(local);
+
+    EXPECT_EQ(gateway.serve_result, 0);
+    EXPECT_EQ(gateway.run_result, 0);
+    EXPECT_EQ(gateway.stats.ticks, kTicks);
+    EXPECT_EQ(gateway.stats.rtt.total, kTicks - 1U);
+    EXPECT_EQ(stats.ticks, kTicks);
+    EXPECT_EQ(stats.rtt.total, kTicks);
+    EXPECT_GT(stats.rtt.min, 0U);
+}
+
+TEST_P(HilTest, TickOutOfOrderEndsSession) {
+    Gateway gateway(address("order"));
+
+    HIL_Link link;
+    HIL_Stats stats;
+    ASSERT_EQ(HIL_connect(&link, address("order").c_str(), kTimeoutMs), 0);
+    ASSERT_EQ(HIL_hello(&link, 2U, &stats), 0);
+
+    uint8_t sensors[2] = {0x08U, 0x08U};
+    uint16_t outputs[2];
+    ASSERT_EQ(HIL_exchange(&link, 0U, sensors, outputs, 2U, &stats), 0);
+
+    /* Tick 1 skipped: the gateway gives up and closes, the peer sees the link go away. */
+    EXPECT_EQ(HIL_exchange(&link, 2U, sensors, outputs, 2U, &stats), -EPIPE);
+    gateway.join();
+    HIL_close(&link);
+
+    EXPECT_EQ(gateway.run_result, -EPROTO);
+    EXPECT_EQ(gateway.stats.ticks, 1U);
+}
+
+TEST_P(HilTest, InvalidSensorWordIsRejected) {
+    Gateway gateway(address("sensor"));
+
+    HIL_Link link;
+    HIL_Stats stats;
+    ASSERT_EQ(HIL_connect(&link, address("sensor").c_str(), kTimeoutMs), 0);
+    ASSERT_EQ(HIL_hello(&link, 1U, &stats), 0);
+
+    HIL_Frame frame {};
+    frame.type = HIL_FRAME_SENSORS;
+    frame.count = 1U;
+    frame.tick = 0U;
+    frame.words[0] = 0x80U;
+    ASSERT_EQ(HIL_send(&link, &frame), 0);
+    EXPECT_EQ(HIL_receive(&link, &frame), -EPIPE);
+    gateway.join();
+    HIL_close(&link);
+
+    EXPECT_EQ(gateway.run_result, -EPROTO);
+}
+
+TEST_P(HilTest, ConnectTimesOutWithoutServer) {
+    HIL_Link link;
+    EXPECT_EQ(HIL_connect(&link, address("missing").c_str(), 20), -ETIMEDOUT);
+    HIL_close(&link);
+}
+
+TEST_P(HilTest, ServeTimesOutWithoutPeer) {
+    HIL_Link link;
+    EXPECT_EQ(HIL_serve(&link, address("lonely").c_str(), 20), -ETIMEDOUT);
+    HIL_close(&link);
+
+    /* The endpoint is gone, a late peer does not find it. */
+    EXPECT_EQ(HIL_connect(&link, address("lonely").c_str(), 20), -ETIMEDOUT);
+}
+
+INSTANTIATE_TEST_SUITE_P(Transports, HilTest, ::testing::Values("unix:", "shm:"),
+                         [](const ::testing::TestParamInfo<const char *> &info) {
+                             return std::string(info.param).substr(0U, std::string(info.param).size() - 1U);
+                         });
+
+TEST(Hil, RejectsUnknownAddresses) {
+    HIL_Link link;
+    EXPECT_EQ(HIL_serve(&link, "tcp:localhost:1234", 10), -EINVAL);
+    EXPECT_EQ(HIL_connect(&link, "/elevator", 10), -EINVAL);
+    EXPECT_EQ(HIL_connect(&link, ("unix:/tmp/" + std::string(200U, 'x')).c_str(), 10), -ENAMETOOLONG);
+}
+
+TEST(Hil, HelloChecksCarCount) {
+    HIL_Link link;
+    HIL_Stats stats;
+    link.fd = -1;
+    link.base = nullptr;
+    EXPECT_EQ(HIL_hello(&link, 0U, &stats), -EINVAL);
+    EXPECT_EQ(HIL_hello(&link, HIL_MAX_CARS + 1U, &stats), -EINVAL);
+}
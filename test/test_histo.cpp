@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "histo.h"
+}
+
+class HistoTest : public ::testing::Test {
+public:
+    Histo histo;
+
+protected:
+    void SetUp() override {
+        Histo_init(&histo);
+    }
+};
+
+TEST_F(HistoTest, Empty) {
+    EXPECT_EQ(histo.total, 0U);
+    EXPECT_EQ(histo.max, 0U);
+    EXPECT_EQ(Histo_percentile(&histo, 50.0), 0U);
+}
+
+TEST_F(HistoTest, SmallValuesAreExact) {
+    for (uint64_t value = 0U; value < HISTO_SUB_BUCKETS; value++) {
+        EXPECT_EQ(Histo_bucket(value), value);
+        EXPECT_EQ(Histo_bucket_low((uint32_t)value), value);
+        EXPECT_EQ(Histo_bucket_high((uint32_t)value), value);
+    }
+}
+
+TEST_F(HistoTest, BucketsCoverTheRange) {
+    /* Buckets are contiguous and every value maps into the bucket bounding it. */
+    for (uint32_t bucket = 1U; bucket < HISTO_BUCKETS; bucket++) {
+        EXPECT_EQ(Histo_bucket_low(bucket), Histo_bucket_high(bucket - 1U) + 1U);
+        EXPECT_EQ(Histo_bucket(Histo_bucket_low(bucket)), bucket);
+        EXPECT_EQ(Histo_bucket(Histo_bucket_high(bucket)), bucket);
+    }
+    EXPECT_EQ(Histo_bucket(UINT64_MAX), HISTO_BUCKETS - 1U);
+    EXPECT_EQ(Histo_bucket_high(HISTO_BUCKETS - 1U), UINT64_MAX);
+}
+
+TEST_F(HistoTest, RelativeError) {
+    for (uint64_t value = HISTO_SUB_BUCKETS; value < 1000000U; value = value * 3U + 1U) {
+        uint32_t bucket = Histo_bucket(value);
+        uint64_t width = Histo_bucket_high(bucket) - Histo_bucket_low(bucket) + 1U;
+        EXPECT_LE(width * HISTO_SUB_BUCKETS, value);
+    }
+}
+
+TEST_F(HistoTest, Percentiles) {
+    for (uint64_t value = 1U; value <= 1000U; value++) {
+        Histo_record(&histo, value);
+    }
+
+    EXPECT_EQ(histo.total, 1000U);
+    EXPECT_EQ(histo.min, 1U);
+    EXPECT_EQ(histo.max, 1000U);
+    EXPECT_EQ(histo.sum, 500500U);
+
+    /* Percentiles are bucket upper bounds, within the relative bucket width. */
+    uint64_t p50 = Histo_percentile(&histo, 50.0);
+    EXPECT_GE(p50, 500U);
+    EXPECT_LE(p50, 500U + 500U / HISTO_SUB_BUCKETS);
+
+    uint64_t p99 = Histo_percentile(&histo, 99.0);
+    EXPECT_GE(p99, 990U);
+    EXPECT_LE(p99, 1000U);
+
+    /* Clamped to the largest sample. */
+    EXPECT_EQ(Histo_percentile(&histo, 100.0), 1000U);
+    EXPECT_EQ(Histo_percentile(&histo, 0.0), 1U);
+}
+
+TEST_F(HistoTest, MergeEqualsRecordingBoth) {
+    Histo other;
+    Histo both;
+    Histo_init(&other);
+    Histo_init(&both);
+
+    for (uint64_t value = 1U; value <= 5000U; value += 7U) {
+        Histo_record(((value % 3U) == 0U) ? &histo : &other, value * value);
+        Histo_record(&both, value * value);
+    }
+
+    Histo_merge(&histo, &other);
+    EXPECT_EQ(histo.total, both.total);
+    EXPECT_EQ(histo.sum, both.sum);
+    EXPECT_EQ(histo.min, both.min);
+    EXPECT_EQ(histo.max, both.max);
+    for (uint32_t i = 0U; i < HISTO_BUCKETS; i++) {
+        ASSERT_EQ(histo.counts[i], both.counts[i]) << "bucket " << i;
+    }
+
+    /* Merging an empty histogram changes nothing. */
+    Histo_init(&other);
+    Histo_merge(&histo, &other);
+    EXPECT_EQ(histo.min, both.min);
+    EXPECT_EQ(Histo_percentile(&histo, 99.0), Histo_percentile(&both, 99.0));
+}
+
+TEST_F(HistoTest, WriteJson) {
+    char buffer[512];
+    FILE *file = fmemopen(buffer, sizeof(buffer), "w");
+    ASSERT_NE(file, nullptr);
+    Histo_write_json(&histo, file);
+    Histo_record(&histo, 3U);
+    Histo_record(&histo, 3U);
+    Histo_record(&histo, 100U);
+    fputc('\n', file);
+    Histo_write_json(&histo, file);
+    fclose(file);
+
+    EXPECT_STREQ(buffer,
+                 "{\"samples\": 0, \"min\": 0, \"p50\": 0, \"p99\": 0, \"p99.9\": 0, \"max\": 0, \"buckets\": []}\n"
+                 "{\"samples\": 3, \"min\": 3, \"p50\": 3, \"p99\": 100, \"p99.9\": 100, \"max\": 100, "
+                 "\"buckets\": [[3, 3, 2], [100, 103, 1]]}");
+}
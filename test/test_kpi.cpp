@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+
+extern "C" {
+#include "kpi.h"
+}
+
+class KpiTest : public ::testing::Test {
+public:
+    Kpi kpi;
+
+protected:
+    void SetUp() override {
+        Kpi_init(&kpi, 6U);
+    }
+
+    /* Reports cycles of a car in the same state. */
+    void hold(uint32_t cycles, uint8_t floor, bool door_open, bool moving) {
+        for (uint32_t i = 0U; i < cycles; i++) {
+            Kpi_cycle(&kpi, floor, door_open, moving, false);
+        }
+    }
+};
+
+TEST_F(KpiTest, TripFromCallToService) {
+    /* Standing with open door, a call to floor 2 arrives. */
+    hold(1U, 0U, true, false);
+    Kpi_call(&kpi, 2U);
+    hold(2U, 0U, true, false);      /* Cycles 2, 3: door still open */
+    hold(1U, 0U, false, false);     /* Cycle 4: door closed */
+    hold(1U, 1U, false, true);      /* Cycle 5: trip starts */
+    hold(1U, 1U, false, false);
+    hold(1U, 2U, false, true);
+    hold(1U, 2U, false, false);
+    Kpi_cycle(&kpi, 2U, true, false, true);   /* Cycle 9: door opens, reset */
+    hold(3U, 2U, true, false);
+    hold(1U, 2U, false, false);     /* Cycle 13: door closed */
+
+    EXPECT_EQ(kpi.cycle, 13U);
+    EXPECT_EQ(Kpi_unserved(&kpi, 2U), 0U);
+
+    /* Registered in cycle 1, served in cycle 9. */
+    ASSERT_EQ(kpi.floor[2].service.total, 1U);
+    EXPECT_EQ(kpi.floor[2].service.max, 8U);
+    EXPECT_EQ(kpi.all.service.total, 1U);
+
+    /* Trip from cycle 5 until the door opened in cycle 9, on floor 2. */
+    ASSERT_EQ(kpi.floor[2].travel.total, 1U);
+    EXPECT_EQ(kpi.floor[2].travel.max, 4U);
+
+    /* Only the dwell that started in the run is counted, the initial one is not. */
+    ASSERT_EQ(kpi.all.dwell.total, 1U);
+    EXPECT_EQ(kpi.floor[2].dwell.max, 4U);
+    EXPECT_EQ(kpi.floor[0].dwell.total, 0U);
+}
+
+TEST_F(KpiTest, ResetNeedsOpenDoorAndPendingCall) {
+    Kpi_call(&kpi, 3U);
+    Kpi_cycle(&kpi, 3U, false, false, true);
+    EXPECT_EQ(kpi.all.service.total, 0U);
+    EXPECT_EQ(Kpi_unserved(&kpi, 3U), 1U);
+
+    /* Another call of the same floor keeps the first registration. */
+    Kpi_call(&kpi, 3U);
+    Kpi_cycle(&kpi, 3U, true, false, true);
+    EXPECT_EQ(kpi.all.service.max, 2U);
+
+    /* Reset without a call, and out of range floors, are ignored. */
+    Kpi_cycle(&kpi, 3U, true, false, true);
+    Kpi_call(&kpi, 6U);
+    Kpi_cycle(&kpi, 6U, true, false, true);
+    EXPECT_EQ(kpi.all.service.total, 1U);
+}
+
+TEST_F(KpiTest, RestartCountsPendingCallsAndForgetsTheCar) {
+    hold(1U, 0U, false, true);      /* Moving at the first report */
+    Kpi_call(&kpi, 1U);
+    hold(1U, 1U, true, false);
+    Kpi_restart(&kpi);
+
+    EXPECT_EQ(Kpi_unserved(&kpi, 1U), 1U);
+    EXPECT_EQ(kpi.all.travel.total, 0U);
+
+    /* The door closing right after the restart has no known opening. */
+    hold(1U, 1U, true, false);
+    hold(1U, 1U, false, false);
+    EXPECT_EQ(kpi.all.dwell.total, 0U);
+}
+
+TEST_F(KpiTest, MergeAndJson) {
+    static Kpi scenarios[2];
+    Kpi_init(&scenarios[0], 6U);
+    Kpi_init(&scenarios[1], 6U);
+
+    Kpi_call(&scenarios[0], 1U);
+    Kpi_cycle(&scenarios[0], 1U, true, false, true);
+    Kpi_call(&scenarios[1], 4U);
+    Kpi_cycle(&scenarios[1], 0U, true, false, false);
+
+    Kpi_merge(&kpi, &scenarios[0]);
+    Kpi_merge(&kpi, &scenarios[1]);
+    EXPECT_EQ(kpi.all.service.total, 1U);
+    EXPECT_EQ(Kpi_unserved(&kpi, 4U), 1U);
+    EXPECT_EQ(kpi.cycle, 2U);
+
+    Kpi small;
+    Kpi_init(&small, 2U);
+    EXPECT_EQ(Kpi_merge(&small, &kpi), -EINVAL);
+
+    char *buffer = nullptr;
+    size_t size = 0U;
+    FILE *file = open_memstream(&buffer, &size);
+    ASSERT_NE(file, nullptr);
+    const char *names[2] = {"first", "second \"quoted\""};
+    EXPECT_EQ(Kpi_write_json(file, scenarios, names, 2U), 0);
+    fclose(file);
+
+    std::string json(buffer, size);
+    free(buffer);
+    EXPECT_NE(json.find("\"name\": \"first\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\": \"second \\\"quoted\\\"\""), std::string::npos);
+    EXPECT_NE(json.find("\"total\": {\"cycles\": 2, \"unserved\": 1,"), std::string::npos);
+    EXPECT_NE(json.find("{\"floor\": 4, \"unserved\": 1, \"service\": {\"samples\": 0"), std::string::npos);
+    EXPECT_NE(json.find("{\"floor\": 1, \"unserved\": 0, \"service\": {\"samples\": 1, \"min\": 1,"),
+              std::string::npos);
+}
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "lockstep.h"
+#include "controller.h"
+#include "condsel.h"
+}
+
+namespace {
+
+/* Pseudo-random sensor words, held for a few cycles each like real inputs. */
+class SensorPattern {
+public:
+    uint8_t next() {
+        if ((cycle_++ & 3U) == 0U) {
+            seed_ = (seed_ * 1103515245U) + 12345U;
+        }
+        return (uint8_t)((seed_ >> 16) & 0x7FU);
+    }
+
+private:
+    uint32_t seed_ = 3U;
+    uint32_t cycle_ = 0U;
+};
+
+}
+
+TEST(LockstepTest, InitStoresChannelBComplemented) {
+    Lockstep lockstep;
+    Lockstep_init(&lockstep);
+
+    EXPECT_EQ(lockstep.channel.state.pc, 0U);
+    EXPECT_EQ(lockstep.channel.instruction, SEQNET_POWER_UP_INSTRUCTION);
+    EXPECT_EQ(lockstep.shadow.state.pc, 0xFFU);
+    EXPECT_EQ(lockstep.shadow.instruction, (uint16_t)~SEQNET_POWER_UP_INSTRUCTION);
+    EXPECT_FALSE(lockstep.safe_stop);
+}
+
+TEST(LockstepTest, MatchesSingleChannel) {
+    Lockstep lockstep;
+    Controller controller;
+    SensorPattern pattern;
+    Lockstep_init(&lockstep);
+    Controller_init(&controller);
+
+    for (uint32_t cycle = 0U; cycle < 100000U; cycle++) {
+        uint8_t sensors = pattern.next();
+        ASSERT_EQ(Lockstep_step(&lockstep, sensors), Controller_step(&controller, sensors)) << "cycle " << cycle;
+        ASSERT_EQ(lockstep.channel.state.pc, controller.state.pc);
+        ASSERT_EQ(lockstep.shadow.state.pc, (uint8_t)~controller.state.pc);
+        ASSERT_EQ(lockstep.shadow.instruction, (uint16_t)~controller.instruction);
+    }
+    EXPECT_FALSE(lockstep.safe_stop);
+}
+
+TEST(LockstepTest, SafeStopOnChannelFault) {
+    /* Faults in one channel, equal flips in two fields of one channel, and a cleared state hitting
+     * both channels alike. */
+    const struct {
+        uint8_t pc_flip;
+        uint16_t instruction_flip;
+        uint8_t shadow_pc_flip;
+        uint16_t shadow_instruction_flip;
+        bool clear;
+    } faults[] = {
+        {0x01U, 0x0000U, 0x00U, 0x0000U, false},
+        {0x00U, 0x0000U, 0x04U, 0x0000U, false},
+        {0x00U, 0x8000U, 0x00U, 0x0000U, false},
+        {0x00U, 0x0000U, 0x00U, 0x0100U, false},
+        {0x01U, 0x0001U, 0x00U, 0x0000U, false},
+        {0x00U, 0x0000U, 0x02U, 0x0002U, false},
+        {0x00U, 0x0000U, 0x00U, 0x0000U, true},
+    };
+
+    for (const auto &fault : faults) {
+        Lockstep lockstep;
+        SensorPattern pattern;
+        Lockstep_init(&lockstep);
+        for (uint32_t cycle = 0U; cycle < 50U; cycle++) {
+            ASSERT_NE(Lockstep_step(&lockstep, pattern.next()), LOCKSTEP_SAFE_STOP);
+        }
+
+        if (fault.clear) {
+            lockstep.channel = Controller{};
+            lockstep.shadow = Controller{};
+        }
+        lockstep.channel.state.pc ^= fault.pc_flip;
+        lockstep.channel.instruction ^= fault.instruction_flip;
+        lockstep.shadow.state.pc ^= fault.shadow_pc_flip;
+        lockstep.shadow.instruction ^= fault.shadow_instruction_flip;
+
+        EXPECT_EQ(Lockstep_step(&lockstep, pattern.next()), LOCKSTEP_SAFE_STOP);
+        EXPECT_TRUE(lockstep.safe_stop);
+
+        /* The safe stop is latched until the next initialization. */
+        Lockstep_init(&lockstep);
+        for (uint32_t cycle = 0U; cycle < 10U; cycle++) {
+            EXPECT_NE(Lockstep_step(&lockstep, pattern.next()), LOCKSTEP_SAFE_STOP);
+        }
+    }
+}
+
+TEST(LockstepTest, SafeStopOnConditionFault) {
+    /* The condition value is evaluated from the stored instruction word of each channel. A fault that
+     * only hits the condition path, a flipped condition select or inversion bit, stops the controller
+     * in the cycle the wrong condition would be used. */
+    const uint16_t condition_bits = (uint16_t)(SEQNET_FIELD_COND_SEL | SEQNET_FIELD_INV);
+    Lockstep reference;
+    SensorPattern pattern;
+    uint32_t wrong_conditions = 0U;
+    Lockstep_init(&reference);
+
+    for (uint32_t cycle = 0U; cycle < 1000U; cycle++) {
+        uint8_t sensors = pattern.next();
+        uint16_t previous = reference.channel.instruction;
+        uint8_t condition = CondSel_eval_packed(SEQNET_COND_INV(previous), SEQNET_COND_SEL(previous), sensors);
+
+        for (uint16_t flip = 1U; flip != 0U; flip = (uint16_t)(flip << 1)) {
+            if ((flip & condition_bits) == 0U) {
+                continue;
+            }
+            uint16_t corrupted = (uint16_t)(previous ^ flip);
+            if (CondSel_eval_packed(SEQNET_COND_INV(corrupted), SEQNET_COND_SEL(corrupted), sensors) != condition) {
+                wrong_conditions++;
+            }
+
+            Lockstep faulty_a = reference;
+            faulty_a.channel.instruction ^= flip;
+            EXPECT_EQ(Lockstep_step(&faulty_a, sensors), LOCKSTEP_SAFE_STOP) << "cycle " << cycle;
+
+            Lockstep faulty_b = reference;
+            faulty_b.shadow.instruction ^= flip;
+            EXPECT_EQ(Lockstep_step(&faulty_b, sensors), LOCKSTEP_SAFE_STOP) << "cycle " << cycle;
+        }
+
+        ASSERT_NE(Lockstep_step(&reference, sensors), LOCKSTEP_SAFE_STOP);
+    }
+
+    /* Enough of the faults change the condition value, not only the word. */
+    EXPECT_GT(wrong_conditions, 1000U);
+}
+
+TEST(LockstepTest, SafeStopRequestsNothing) {
+    EXPECT_FALSE(SEQNET_MOVE_UP(LOCKSTEP_SAFE_STOP));
+    EXPECT_FALSE(SEQNET_MOVE_DOWN(LOCKSTEP_SAFE_STOP));
+    EXPECT_FALSE(SEQNET_DOOR_OPEN(LOCKSTEP_SAFE_STOP));
+    EXPECT_FALSE(SEQNET_RESET(LOCKSTEP_SAFE_STOP));
+    EXPECT_EQ(SEQNET_REQUESTS(LOCKSTEP_SAFE_STOP), 0U);
+}
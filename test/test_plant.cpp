@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+#include <cerrno>
+#include <cmath>
+
+extern "C" {
+#include "plant.h"
+#include "condsel.h"
+#include "elevator_abi.h"
+}
+
+/* Integration step of the tests [s]. */
+static const float kDt = 0.01f;
+
+class PlantTest : public ::testing::Test {
+public:
+    Plant plant {};
+    Plant_Config config {};
+
+protected:
+    void SetUp() override {
+        Plant_default_config(&config, 6U);
+        ASSERT_EQ(Plant_create(&plant, 1U, &config), 0);
+    }
+
+    void TearDown() override {
+        Plant_destroy(&plant);
+    }
+
+    bool standing() const {
+        return (plant.velocity[0] == 0.0f) && (plant.position[0] == plant.target[0]);
+    }
+};
+
+TEST(PlantConfigTest, CreateRejectsInvalidConfig) {
+    Plant plant {};
+    Plant_Config config {};
+    Plant_default_config(&config, 6U);
+
+    EXPECT_EQ(Plant_create(&plant, 0U, &config), -EINVAL);
+    config.floors = 1U;
+    EXPECT_EQ(Plant_create(&plant, 1U, &config), -EINVAL);
+    config.floors = 33U;
+    EXPECT_EQ(Plant_create(&plant, 1U, &config), -EINVAL);
+    config.floors = 6U;
+    config.max_accel = 0.0f;
+    EXPECT_EQ(Plant_create(&plant, 1U, &config), -EINVAL);
+}
+
+TEST_F(PlantTest, TravelsOneFloorWithinLimits) {
+    Plant_place(&plant, 0U, 0U, false);
+    Plant_command(&plant, 0U, ELEV_OUT_MOVE_UP);
+    EXPECT_FLOAT_EQ(plant.target[0], config.floor_height);
+
+    float time = 0.0f;
+    float previous = 0.0f;
+    bool left_level = false;
+    do {
+        Plant_step(&plant, kDt);
+        time += kDt;
+
+        EXPECT_LE(std::fabs(plant.velocity[0]), config.max_speed);
+        /* The stop on the target may take up to two steps of velocity change at once. */
+        float max_dv = config.max_accel * kDt * (standing() ? 2.0f : 1.0f) * 1.01f;
+        EXPECT_LE(std::fabs(plant.velocity[0] - previous), max_dv);
+        EXPECT_GE(plant.velocity[0], 0.0f);
+        EXPECT_TRUE(Plant_is_door_closed(&plant, 0U));
+        previous = plant.velocity[0];
+        left_level = left_level || !Plant_is_level(&plant, 0U);
+    } while (!standing() && (time < 20.0f));
+
+    /* Trapezoidal profile: d / v + v / a. */
+    EXPECT_NEAR(time, (config.floor_height / config.max_speed) + (config.max_speed / config.max_accel), 0.1f);
+    EXPECT_TRUE(left_level);
+    EXPECT_FLOAT_EQ(plant.position[0], config.floor_height);
+    EXPECT_TRUE(Plant_is_level(&plant, 0U));
+    EXPECT_EQ(Plant_floor(&plant, 0U), 1U);
+}
+
+TEST_F(PlantTest, MoveRequestsNeedStandingCarWithClosedDoor) {
+    /* The door is open after create. */
+    Plant_command(&plant, 0U, ELEV_OUT_MOVE_UP);
+    EXPECT_FLOAT_EQ(plant.target[0], 0.0f);
+
+    /* No floor below floor 0, both directions at once are ignored. */
+    Plant_place(&plant, 0U, 0U, false);
+    Plant_command(&plant, 0U, ELEV_OUT_MOVE_DOWN);
+    Plant_command(&plant, 0U, ELEV_OUT_MOVE_UP | ELEV_OUT_MOVE_DOWN);
+    EXPECT_FLOAT_EQ(plant.target[0], 0.0f);
+
+    /* Requests while travelling are ignored, and the door is held closed. */
+    Plant_command(&plant, 0U, ELEV_OUT_MOVE_UP);
+    Plant_step(&plant, kDt);
+    Plant_command(&plant, 0U, ELEV_OUT_MOVE_UP | ELEV_OUT_DOOR_OPEN);
+    Plant_step(&plant, kDt);
+    EXPECT_FLOAT_EQ(plant.target[0], config.floor_height);
+    EXPECT_TRUE(Plant_is_door_closed(&plant, 0U));
+
+    /* Top floor. */
+    Plant_place(&plant, 0U, 5U, false);
+    Plant_command(&plant, 0U, ELEV_OUT_MOVE_UP);
+    EXPECT_FLOAT_EQ(plant.target[0], 5.0f * config.floor_height);
+    Plant_command(&plant, 0U, ELEV_OUT_MOVE_DOWN);
+    EXPECT_FLOAT_EQ(plant.target[0], 4.0f * config.floor_height);
+}
+
+TEST_F(PlantTest, DoorEndSwitches) {
+    Plant_place(&plant, 0U, 2U, false);
+    EXPECT_TRUE(Plant_is_door_closed(&plant, 0U));
+    EXPECT_FALSE(Plant_is_door_open(&plant, 0U));
+
+    Plant_command(&plant, 0U, ELEV_OUT_DOOR_OPEN);
+    float time = 0.0f;
+    while (!Plant_is_door_open(&plant, 0U) && (time < 10.0f)) {
+        Plant_step(&plant, kDt);
+        time += kDt;
+        if (!Plant_is_door_open(&plant, 0U)) {
+            EXPECT_FALSE(Plant_is_door_closed(&plant, 0U));
+        }
+    }
+    EXPECT_NEAR(time, config.door_time, 2.0f * kDt);
+
+    uint8_t sensors = Plant_sense(&plant, 0U, 0U);
+    EXPECT_EQ(sensors, CONDSEL_IN_DOOR_OPEN | CONDSEL_IN_ELEVATOR_POS_OK | CONDSEL_IN_DOOR_POS_OK);
+
+    /* Half way closed, neither end-switch is active. */
+    Plant_command(&plant, 0U, 0U);
+    for (int i = 0; i < 100; i++) {
+        Plant_step(&plant, kDt);
+    }
+    EXPECT_EQ(Plant_sense(&plant, 0U, 0U), CONDSEL_IN_ELEVATOR_POS_OK);
+}
+
+TEST_F(PlantTest, SenseCallsRelativeToNearestFloor) {
+    Plant_place(&plant, 0U, 2U, false);
+    const uint8_t base = CONDSEL_IN_DOOR_CLOSED | CONDSEL_IN_ELEVATOR_POS_OK | CONDSEL_IN_DOOR_POS_OK;
+
+    EXPECT_EQ(Plant_sense(&plant, 0U, 1U << 0), base | CONDSEL_IN_BELOW);
+    EXPECT_EQ(Plant_sense(&plant, 0U, 1U << 2), base | CONDSEL_IN_SAME);
+    EXPECT_EQ(Plant_sense(&plant, 0U, 1U << 5), base | CONDSEL_IN_ABOVE);
+    EXPECT_EQ(Plant_sense(&plant, 0U, 0x25U), base | CONDSEL_IN_BELOW | CONDSEL_IN_SAME | CONDSEL_IN_ABOVE);
+}
+
+TEST_F(PlantTest, PosDetGatesCallsBetweenFloors) {
+    Plant_Car car {&plant, 0U};
+    PosDet_Ops posdet {};
+    Plant_init_posdet(&posdet, &car);
+
+    CondSel_In inputs {false, true, false, true, false};
+    Plant_place(&plant, 0U, 0U, false);
+    EXPECT_TRUE(CondSel_calc_ops(&posdet, false, 2U, inputs));
+
+    Plant_command(&plant, 0U, ELEV_OUT_MOVE_UP);
+    for (int i = 0; i < 100; i++) {
+        Plant_step(&plant, kDt);
+    }
+    EXPECT_FALSE(Plant_is_level(&plant, 0U));
+    EXPECT_FALSE(CondSel_calc_ops(&posdet, false, 2U, inputs));
+    EXPECT_TRUE(CondSel_calc_ops(&posdet, false, 4U, inputs));
+
+    /* The packed sensor word gates the same way. */
+    uint8_t sensors = Plant_sense(&plant, 0U, 1U << 1);
+    EXPECT_EQ(CondSel_eval_packed(false, 2U, sensors), 0U);
+}
+
+TEST_F(PlantTest, ClosedLoopServesCall) {
+    /* Controller and plant in a loop, the way a simulation drives them. */
+    ElevBatch *batch = elev_batch_create(1U);
+    ASSERT_NE(batch, nullptr);
+
+    uint32_t calls = 1U << 4;
+    uint32_t gated_cycles = 0U;
+    uint32_t cycle = 0U;
+    for (; (cycle < 10000U) && ((calls != 0U) || !Plant_is_door_open(&plant, 0U)); cycle++) {
+        uint8_t sensors = Plant_sense(&plant, 0U, calls);
+        if ((sensors & CONDSEL_IN_ELEVATOR_POS_OK) == 0U) {
+            gated_cycles++;
+        }
+
+        uint16_t instruction = 0U;
+        ASSERT_EQ(elev_batch_step(batch, &sensors, &instruction, 1U), ELEV_OK);
+        if (((instruction & ELEV_OUT_RESET_CALL) != 0U) && Plant_is_level(&plant, 0U)) {
+            calls &= ~(1U << Plant_floor(&plant, 0U));
+        }
+
+        Plant_command(&plant, 0U, instruction);
+        Plant_step(&plant, kDt);
+    }
+
+    EXPECT_EQ(calls, 0U);
+    EXPECT_EQ(Plant_floor(&plant, 0U), 4U);
+    EXPECT_TRUE(Plant_is_level(&plant, 0U));
+    EXPECT_TRUE(Plant_is_door_open(&plant, 0U));
+    EXPECT_GT(gated_cycles, 0U);
+    /* Close the door, four floors and open the door again. */
+    EXPECT_LT(cycle * kDt, 30.0f);
+
+    elev_batch_destroy(batch);
+}
@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "posdet.h"
+#include "condsel.h"
+}
+
+/* CondSel with the PosDet binding the tests are linked with, without an installed mock: the inline
+ * stubs of the production library, or the link-time binding with the mock's default. Both pass the
+ * position checks. */
+
+TEST(PosDetBindingTest, StubsReportPositionsOk) {
+    EXPECT_TRUE(PosDet_is_elevator_position_ok());
+    EXPECT_TRUE(PosDet_is_door_position_ok());
+}
+
+TEST(PosDetBindingTest, CalcMatchesPackedWithPositionsOk) {
+    /* Every input combination, condition index and inversion gives the packed evaluation with
+     * both position checks passed. */
+    for (uint32_t bits = 0U; bits < 32U; bits++) {
+        CondSel_In values {
+            (bits & CONDSEL_IN_BELOW) != 0U,
+            (bits & CONDSEL_IN_SAME) != 0U,
+            (bits & CONDSEL_IN_ABOVE) != 0U,
+            (bits & CONDSEL_IN_DOOR_CLOSED) != 0U,
+            (bits & CONDSEL_IN_DOOR_OPEN) != 0U,
+        };
+        uint8_t sensors = CondSel_pack(values, true, true);
+
+        EXPECT_EQ(CondSel_vector(values), CondSel_eval_packed(false, CONDSEL_INDEX_DISPATCH, sensors));
+        for (uint32_t index = 0U; index < 10U; index++) {
+            for (bool invert : {false, true}) {
+                ASSERT_EQ(CondSel_eval(invert, (uint8_t)index, values),
+                          CondSel_eval_packed(invert, (uint8_t)index, sensors))
+                    << "inputs=" << bits << " index=" << index << " invert=" << invert;
+                if (index != CONDSEL_INDEX_DISPATCH) {
+                    ASSERT_EQ(CondSel_calc(invert, (uint8_t)index, values) ? 1U : 0U,
+                              CondSel_eval_packed(invert, (uint8_t)index, sensors));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+extern "C" {
+#include "recorder.h"
+#include "condsel.h"
+#include "seqnet.h"
+}
+
+/* Sensor word of a car standing with closed door and a call above, positions ok. */
+static const uint8_t kCallAbove = CONDSEL_IN_ABOVE | CONDSEL_IN_DOOR_CLOSED | CONDSEL_IN_ELEVATOR_POS_OK | CONDSEL_IN_DOOR_POS_OK;
+static const uint8_t kIdle = CONDSEL_IN_DOOR_OPEN | CONDSEL_IN_ELEVATOR_POS_OK | CONDSEL_IN_DOOR_POS_OK;
+
+class RecorderTest : public ::testing::Test {
+public:
+    std::string path;
+
+protected:
+    void SetUp() override {
+        path = "recorder_test_" + std::to_string(getpid()) + ".elrr";
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+
+    /* Drives the controller like the emulator does and records it. */
+    void record(const uint8_t *sensors, size_t cycles, Recorder *recorder) {
+        uint8_t condition = 0U;
+        SeqNet_init();
+        Recorder_reset(recorder);
+        for (size_t i = 0U; i < cycles; i++) {
+            SeqNet_Out out = SeqNet_loop(condition);
+            condition = CondSel_eval_packed(out.cond_inv, out.cond_sel, sensors[i]);
+            Recorder_cycle(recorder, sensors[i], SeqNet_encode(&out));
+        }
+    }
+};
+
+TEST_F(RecorderTest, RecordAndReplay) {
+    uint8_t sensors[1000];
+    for (size_t i = 0U; i < 1000U; i++) {
+        sensors[i] = (i < 300U) ? kIdle : kCallAbove;
+    }
+
+    Recorder recorder;
+    ASSERT_EQ(Recorder_open(&recorder, path.c_str()), 0);
+    record(sensors, 1000U, &recorder);
+    record(sensors, 500U, &recorder);
+    EXPECT_EQ(recorder.cycles, 1500U);
+    ASSERT_EQ(Recorder_close(&recorder), 0);
+
+    /* Two runs per recording, plus the reset markers. */
+    EXPECT_EQ(recorder.runs, 4U);
+
+    Recorder_Result result;
+    ASSERT_EQ(Recorder_replay(path.c_str(), &result), 0);
+    EXPECT_EQ(result.cycles, 1500U);
+    EXPECT_EQ(result.runs, 4U);
+    EXPECT_EQ(result.resets, 2U);
+    EXPECT_EQ(result.mismatches, 0U);
+}
+
+TEST_F(RecorderTest, LongRunsStaySmall) {
+    Recorder recorder;
+    ASSERT_EQ(Recorder_open(&recorder, path.c_str()), 0);
+
+    /* A million idle cycles, a trip, another million idle cycles. */
+    uint8_t condition = 0U;
+    SeqNet_init();
+    Recorder_reset(&recorder);
+    for (uint32_t i = 0U; i < 2000020U; i++) {
+        uint8_t sensors = ((i >= 1000000U) && (i < 1000020U)) ? kCallAbove : kIdle;
+        SeqNet_Out out = SeqNet_loop(condition);
+        condition = CondSel_eval_packed(out.cond_inv, out.cond_sel, sensors);
+        Recorder_cycle(&recorder, sensors, SeqNet_encode(&out));
+    }
+    ASSERT_EQ(Recorder_close(&recorder), 0);
+
+    FILE *file = std::fopen(path.c_str(), "rb");
+    ASSERT_NE(file, nullptr);
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fclose(file);
+    EXPECT_LT(size, 64);
+
+    Recorder_Result result;
+    ASSERT_EQ(Recorder_replay(path.c_str(), &result), 0);
+    EXPECT_EQ(result.cycles, 2000020U);
+    EXPECT_EQ(result.mismatches, 0U);
+}
+
+TEST_F(RecorderTest, DetectsMismatch) {
+    uint8_t sensors[200];
+    for (size_t i = 0U; i < 200U; i++) {
+        sensors[i] = (i < 100U) ? kIdle : kCallAbove;
+    }
+
+    /* Record different outputs than the controller produces for these inputs. */
+    Recorder recorder;
+    ASSERT_EQ(Recorder_open(&recorder, path.c_str()), 0);
+    Recorder_reset(&recorder);
+    for (size_t i = 0U; i < 200U; i++) {
+        Recorder_cycle(&recorder, sensors[i], (i == 150U) ? 0x0100U : 0x0000U);
+    }
+    ASSERT_EQ(Recorder_close(&recorder), 0);
+
+    Recorder_Result result;
+    ASSERT_EQ(Recorder_replay(path.c_str(), &result), 0);
+    EXPECT_EQ(result.cycles, 200U);
+    EXPECT_GT(result.mismatches, 0U);
+    EXPECT_EQ(result.first_mismatch, 0U);
+}
+
+TEST_F(RecorderTest, RejectsMalformedFile) {
+    FILE *file = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    std::fputs("not a recording", file);
+    std::fclose(file);
+
+    Recorder_Result result;
+    EXPECT_EQ(Recorder_replay(path.c_str(), &result), -EILSEQ);
+    EXPECT_LT(Recorder_replay("missing_recording.elrr", &result), 0);
+}
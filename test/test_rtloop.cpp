@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <sched.h>
+
+extern "C" {
+#include "rtloop.h"
+}
+
+#if defined(__linux__)
+
+static bool count_cycle(void *context) {
+    unsigned *calls = static_cast<unsigned *>(context);
+    (*calls)++;
+    return true;
+}
+
+static bool stop_after_three(void *context) {
+    unsigned *calls = static_cast<unsigned *>(context);
+    (*calls)++;
+    return *calls < 3U;
+}
+
+TEST(RtLoopTest, RunsConfiguredCycles) {
+    RtLoop_Config config {};
+    config.period_ns = 200000U;
+    config.cycles = 25U;
+    config.cpu = -1;
+    static RtLoop_Stats stats;
+    unsigned calls = 0U;
+
+    ASSERT_EQ(RtLoop_run(&config, count_cycle, &calls, &stats), 0);
+
+    EXPECT_EQ(calls, 25U);
+    EXPECT_EQ(stats.cycles, 25U);
+    EXPECT_EQ(stats.jitter.total, 25U);
+    EXPECT_EQ(stats.exec.total, 25U);
+    EXPECT_EQ(stats.overrun.total, stats.overruns);
+}
+
+TEST(RtLoopTest, CycleFunctionStops) {
+    RtLoop_Config config {};
+    config.period_ns = 100000U;
+    config.cycles = 0U;
+    config.cpu = -1;
+    static RtLoop_Stats stats;
+    unsigned calls = 0U;
+
+    ASSERT_EQ(RtLoop_run(&config, stop_after_three, &calls, &stats), 0);
+
+    EXPECT_EQ(calls, 3U);
+    EXPECT_EQ(stats.cycles, 3U);
+}
+
+static bool count_pinned_cycle(void *context) {
+    unsigned *calls = static_cast<unsigned *>(context);
+    cpu_set_t set;
+    if ((sched_getaffinity(0, sizeof(set), &set) == 0) && (CPU_COUNT(&set) == 1)) {
+        (*calls)++;
+    }
+    return true;
+}
+
+TEST(RtLoopTest, RestoresAffinity) {
+    cpu_set_t before;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(before), &before), 0);
+    int cpu = 0;
+    while (!CPU_ISSET(cpu, &before)) {
+        cpu++;
+    }
+
+    RtLoop_Config config {};
+    config.period_ns = 100000U;
+    config.cycles = 5U;
+    config.cpu = cpu;
+    static RtLoop_Stats stats;
+    unsigned calls = 0U;
+
+    ASSERT_EQ(RtLoop_run(&config, count_pinned_cycle, &calls, &stats), 0);
+    EXPECT_EQ(calls, 5U);
+
+    cpu_set_t after;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(after), &after), 0);
+    EXPECT_TRUE(CPU_EQUAL(&before, &after));
+}
+
+TEST(RtLoopTest, InvalidPeriod) {
+    RtLoop_Config config {};
+    config.period_ns = 0U;
+    config.cycles = 1U;
+    config.cpu = -1;
+    static RtLoop_Stats stats;
+    unsigned calls = 0U;
+
+    EXPECT_LT(RtLoop_run(&config, count_cycle, &calls, &stats), 0);
+    EXPECT_EQ(calls, 0U);
+}
+
+#endif
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+#include "scenario.hpp"
+
+using elevator::Car;
+using elevator::Scenario;
+using elevator::Scheduler;
+
+class ScenarioTest : public ::testing::Test {
+public:
+    Plant_Config config {};
+
+protected:
+    void SetUp() override {
+        Plant_default_config(&config, 6U);
+    }
+};
+
+/* Rides to a floor and records the cycle of every step. */
+static Scenario ride(Car car, uint8_t floor, std::vector<uint64_t> *log) {
+    car.call(floor);
+    co_await car.wait_floor(floor);
+    log->push_back(car.cycle());
+    co_await car.wait_door_open();
+    log->push_back(car.cycle());
+    co_await car.wait_served(floor);
+    log->push_back(car.cycle());
+}
+
+TEST_F(ScenarioTest, RideResumesWhenConditionsFire) {
+    Scheduler scheduler(1U, config);
+    std::vector<uint64_t> log;
+    scheduler.spawn(ride(scheduler.car(0U), 3U, &log));
+
+    uint64_t cycles = scheduler.run(100000U);
+    EXPECT_EQ(scheduler.live(), 0U);
+    ASSERT_EQ(log.size(), 3U);
+
+    /* Close the door, three floors, open the door. The call is served on arrival. */
+    EXPECT_GT(log[0], 0U);
+    EXPECT_LT(log[0], log[1]);
+    EXPECT_LE(log[2], log[1]);
+    EXPECT_EQ(cycles, log[1]);
+
+    Car car = scheduler.car(0U);
+    EXPECT_EQ(car.floor(), 3U);
+    EXPECT_TRUE(car.level());
+    EXPECT_TRUE(car.door_open());
+    EXPECT_EQ(car.pending_calls(), 0U);
+}
+
+TEST_F(ScenarioTest, ReadyConditionsDoNotSuspend) {
+    Scheduler scheduler(1U, config);
+    bool done = false;
+
+    auto script = [](Car car, bool *done) -> Scenario {
+        /* Standing on floor 0 with open door after create. */
+        co_await car.wait_floor(0U);
+        co_await car.wait_door_open();
+        co_await car.wait_idle();
+        co_await car.wait_cycles(0U);
+        *done = true;
+    };
+    scheduler.spawn(script(scheduler.car(0U), &done));
+
+    EXPECT_EQ(scheduler.run(10U), 0U);
+    EXPECT_TRUE(done);
+}
+
+TEST_F(ScenarioTest, CyclesWaitExactly) {
+    Scheduler scheduler(1U, config);
+    std::vector<uint64_t> log;
+
+    auto script = [](Car car, std::vector<uint64_t> *log) -> Scenario {
+        for (uint64_t n : {1U, 5U, 20U}) {
+            co_await car.wait_cycles(n);
+            log->push_back(car.cycle());
+        }
+    };
+    scheduler.spawn(script(scheduler.car(0U), &log));
+
+    EXPECT_EQ(scheduler.run(1000U), 26U);
+    EXPECT_EQ(log, (std::vector<uint64_t> {1U, 6U, 26U}));
+}
+
+TEST_F(ScenarioTest, SubroutinesAndBudget) {
+    Scheduler scheduler(2U, config);
+    std::vector<uint64_t> log;
+
+    auto tour = [](Car car, std::vector<uint64_t> *log) -> Scenario {
+        co_await ride(car, 2U, log);
+        co_await ride(car, 5U, log);
+        co_await ride(car, 0U, log);
+    };
+    scheduler.spawn(tour(scheduler.car(1U), &log));
+
+    /* A small budget returns with the scenario still waiting, the next run continues. */
+    EXPECT_EQ(scheduler.run(10U), 10U);
+    EXPECT_EQ(scheduler.live(), 1U);
+    scheduler.run(1000000U);
+    EXPECT_EQ(scheduler.live(), 0U);
+    EXPECT_EQ(log.size(), 9U);
+    EXPECT_EQ(scheduler.car(1U).floor(), 0U);
+
+    /* The other car never moved. */
+    EXPECT_FLOAT_EQ(scheduler.plant().position[0], 0.0f);
+}
+
+TEST_F(ScenarioTest, ManyScenariosOnSharedCars) {
+    constexpr uint32_t kCars = 64U;
+    constexpr uint32_t kScenarios = 10000U;
+    Scheduler scheduler(kCars, config);
+    uint32_t finished = 0U;
+
+    auto script = [](Car car, uint32_t n, uint32_t *finished) -> Scenario {
+        co_await car.wait_cycles(n % 97U);
+        car.call((uint8_t)(n % 6U));
+        co_await car.wait_served((uint8_t)(n % 6U));
+        (*finished)++;
+    };
+    for (uint32_t n = 0U; n < kScenarios; n++) {
+        scheduler.spawn(script(scheduler.car(n % kCars), n, &finished));
+    }
+
+    scheduler.run(1000000U);
+    EXPECT_EQ(scheduler.live(), 0U);
+    EXPECT_EQ(finished, kScenarios);
+}
+
+TEST_F(ScenarioTest, ExceptionsPropagate) {
+    Scheduler scheduler(1U, config);
+
+    auto failing = [](Car car) -> Scenario {
+        co_await car.wait_cycles(3U);
+        throw std::runtime_error("scenario failed");
+    };
+    auto caller = [&failing](Car car, bool *caught) -> Scenario {
+        try {
+            co_await failing(car);
+        } catch (const std::runtime_error &) {
+            *caught = true;
+        }
+    };
+
+    bool caught = false;
+    scheduler.spawn(caller(scheduler.car(0U), &caught));
+    scheduler.run(100U);
+    EXPECT_TRUE(caught);
+
+    scheduler.spawn(failing(scheduler.car(0U)));
+    EXPECT_THROW(scheduler.run(100U), std::runtime_error);
+    EXPECT_EQ(scheduler.live(), 0U);
+}
+
+TEST_F(ScenarioTest, UnfinishedScenariosAreDestroyed) {
+    std::vector<uint64_t> log;
+    {
+        Scheduler scheduler(1U, config);
+        scheduler.spawn(ride(scheduler.car(0U), 4U, &log));
+        scheduler.run(5U);
+        EXPECT_EQ(scheduler.live(), 1U);
+    }
+    EXPECT_TRUE(log.empty());
+}
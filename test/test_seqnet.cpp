@@ -2,6 +2,7 @@
 
 extern "C" {
 #include "seqnet.h"
+#include "condsel.h"
 }
 
 class SeqNetTest : public ::testing::Test {
@@ -62,13 +63,14 @@ TEST_F(SeqNetTest, FullSequence_GroundToFloor2) {
     EXPECT_EQ(out.cond_sel, 4);
 
     /* Door is closed. */
-    /* PC jumps to CHOOSE_DIRECTION state. */
+    /* PC jumps to CHOOSE_DIRECTION state, which dispatches on the packed condition vector. */
     out = SeqNet_loop(true);
-    /* The call is from above. */
-    EXPECT_EQ(out.cond_sel, 3);
+    EXPECT_EQ(out.cond_sel, CONDSEL_INDEX_DISPATCH);
+    EXPECT_EQ(out.dispatch, true);
 
+    /* The call is from above. */
     /* PC jumps to MOVE_UP state. */
-    out = SeqNet_loop(true);
+    out = SeqNet_loop(CONDSEL_VEC_ABOVE | CONDSEL_VEC_DOOR_CLOSED);
     EXPECT_EQ(out.cond_sel, 2);
     EXPECT_EQ(out.req_move_up,false);
 
@@ -98,3 +100,102 @@ TEST_F(SeqNetTest, FullSequence_GroundToFloor2) {
     EXPECT_EQ(out.req_door_state,true);
     EXPECT_EQ(out.req_reset,true);
 }
+
+/* Steps the network from power-up to the CHOOSE_DIRECTION state and returns its instruction. */
+static SeqNet_Out enter_choose_direction() {
+    SeqNet_init();
+    SeqNet_loop(false);
+    SeqNet_loop(false);
+    SeqNet_loop(true);
+    return SeqNet_loop(true);
+}
+
+TEST_F(SeqNetTest, ChooseDirection_ResolvesInOneCycle) {
+    /* Every key of the direction table reaches its target state in a single cycle. */
+    struct { uint8_t vector; uint8_t cond_sel; bool door_state; bool reset; } const cases[] = {
+        { 0U,                                                       2U, true,  true  }, /* IDLE */
+        { CONDSEL_VEC_BELOW,                                        2U, false, false }, /* MOVE_DOWN */
+        { CONDSEL_VEC_SAME,                                         5U, true,  true  }, /* ARRIVED */
+        { CONDSEL_VEC_SAME | CONDSEL_VEC_BELOW,                     2U, false, false }, /* MOVE_DOWN */
+        { CONDSEL_VEC_ABOVE,                                        2U, false, false }, /* MOVE_UP */
+        { CONDSEL_VEC_ABOVE | CONDSEL_VEC_BELOW,                    2U, false, false }, /* MOVE_UP */
+        { CONDSEL_VEC_ABOVE | CONDSEL_VEC_SAME,                     2U, false, false }, /* MOVE_UP */
+        { CONDSEL_VEC_ABOVE | CONDSEL_VEC_SAME | CONDSEL_VEC_BELOW, 2U, false, false }, /* MOVE_UP */
+    };
+
+    for (const auto &c : cases) {
+        SeqNet_Out out = enter_choose_direction();
+        ASSERT_EQ(out.dispatch, true);
+
+        /* The door bit is not part of the key. */
+        out = SeqNet_loop((uint8_t)(c.vector | CONDSEL_VEC_DOOR_CLOSED));
+        EXPECT_EQ(out.dispatch, false);
+        EXPECT_EQ(out.cond_sel, c.cond_sel);
+        EXPECT_EQ(out.req_door_state, c.door_state);
+        EXPECT_EQ(out.req_reset, c.reset);
+    }
+}
+
+TEST_F(SeqNetTest, ChooseDirection_MoveDownAfterDispatch) {
+    SeqNet_Out out = enter_choose_direction();
+
+    /* PC jumps to MOVE_DOWN state. */
+    out = SeqNet_loop(CONDSEL_VEC_BELOW);
+    EXPECT_EQ(out.cond_sel, 2);
+    EXPECT_EQ(out.req_move_down,false);
+
+    /* PC incremented. */
+    out = SeqNet_loop(false);
+    EXPECT_EQ(out.cond_sel, 7);
+    EXPECT_EQ(out.req_move_down,true);
+    EXPECT_EQ(out.req_move_up,false);
+}
+
+TEST_F(SeqNetTest, EncodeRoundTrip) {
+    /* Every instruction of a full trip encodes back into a word that decodes the same. */
+    SeqNet_init();
+    SeqNet_Out out = SeqNet_loop(false);
+    const uint8_t conditions[] = {0U, 1U, 1U, CONDSEL_VEC_ABOVE, 0U, 1U, 0U, 1U, 1U, 1U};
+
+    for (uint8_t condition : conditions) {
+        uint16_t word = SeqNet_encode(&out);
+        EXPECT_EQ(word & 0xFFU, out.jump_addr);
+        EXPECT_EQ(((word >> 8) & 1U) != 0U, out.req_move_up);
+        EXPECT_EQ(((word >> 9) & 1U) != 0U, out.req_move_down);
+        EXPECT_EQ(((word >> 10) & 1U) != 0U, out.req_door_state);
+        EXPECT_EQ(((word >> 11) & 1U) != 0U, out.req_reset);
+        EXPECT_EQ((word >> 12) & 7U, out.cond_sel);
+        EXPECT_EQ(((word >> 15) & 1U) != 0U, out.cond_inv);
+        out = SeqNet_loop(condition);
+    }
+}
+
+TEST_F(SeqNetTest, DispatchTable_KeyedOnCallsOrDoor) {
+    /* A table of 16 jump addresses, each one pointing to its own target word. Without the inversion bit
+     * the dispatch masks the door bit and uses the first 8 entries, with it the door bit selects the upper 8. */
+    const uint16_t dispatch = (uint16_t)(CONDSEL_INDEX_DISPATCH << SEQNET_SHIFT_COND_SEL);
+    const uint8_t calls_keyed = 1U;
+    const uint8_t door_keyed = 2U;
+    const uint8_t table = 16U;
+    const uint8_t targets = 64U;
+    uint16_t image[SEQNET_PROG_MEM_SIZE] = {};
+
+    image[calls_keyed] = (uint16_t)(dispatch | table);
+    image[door_keyed] = (uint16_t)(SEQNET_FIELD_INV | dispatch | table);
+    for (uint8_t key = 0U; key < 16U; key++) {
+        image[table + key] = (uint16_t)(targets + key);
+        image[targets + key] = (uint16_t)(SEQNET_FIELD_MOVE_UP | key);
+    }
+
+    for (uint8_t key = 0U; key < 16U; key++) {
+        /* Bits above the key are not part of it either. */
+        const uint8_t condition = (uint8_t)(key | CONDSEL_IN_DOOR_OPEN | CONDSEL_IN_ELEVATOR_POS_OK);
+        SeqNet_State state {calls_keyed};
+        EXPECT_EQ(SeqNet_step_image(image, &state, condition), image[targets + (key & 7U)]) << "key " << +key;
+        EXPECT_EQ(state.pc, targets + (key & 7U));
+
+        state.pc = door_keyed;
+        EXPECT_EQ(SeqNet_step_image(image, &state, condition), image[targets + key]) << "key " << +key;
+        EXPECT_EQ(state.pc, targets + key);
+    }
+}
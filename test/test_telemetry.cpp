@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cerrno>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+extern "C" {
+#include "telemetry.h"
+}
+
+class TelemetryTest : public ::testing::Test {
+public:
+    Telemetry writer;
+    Telemetry reader;
+    std::string name;
+
+protected:
+    void SetUp() override {
+        name = "/elevator_test_" + std::to_string(getpid());
+        ASSERT_EQ(Telemetry_create(&writer, name.c_str(), 2U), 0);
+        ASSERT_EQ(Telemetry_open(&reader, name.c_str()), 0);
+    }
+
+    void TearDown() override {
+        Telemetry_close(&reader);
+        Telemetry_close(&writer);
+    }
+};
+
+/* Fills every field from the cycle, so a torn snapshot is detectable. */
+static Telemetry_Data make_data(uint64_t cycle) {
+    Telemetry_Data data {};
+    data.cycle = cycle;
+    data.pending_calls = (uint32_t)(cycle * 2654435761U);
+    data.pc = (uint8_t)cycle;
+    data.floor = (uint8_t)(cycle >> 8);
+    data.door = (uint8_t)(cycle & 1U);
+    data.movement = (uint8_t)(cycle % 3U);
+    return data;
+}
+
+TEST_F(TelemetryTest, PublishAndRead) {
+    Telemetry_Data data {};
+
+    EXPECT_EQ(reader.record_count, 2U);
+
+    /* Nothing published yet. */
+    EXPECT_FALSE(Telemetry_read(&reader, 0U, &data));
+
+    Telemetry_Data published = make_data(12345U);
+    Telemetry_publish(&writer, 1U, &published);
+
+    EXPECT_FALSE(Telemetry_read(&reader, 0U, &data));
+    ASSERT_TRUE(Telemetry_read(&reader, 1U, &data));
+    EXPECT_EQ(data.cycle, published.cycle);
+    EXPECT_EQ(data.pending_calls, published.pending_calls);
+    EXPECT_EQ(data.pc, published.pc);
+    EXPECT_EQ(data.floor, published.floor);
+    EXPECT_EQ(data.door, published.door);
+    EXPECT_EQ(data.movement, published.movement);
+
+    /* Out of range records are ignored. */
+    Telemetry_publish(&writer, 2U, &published);
+    EXPECT_FALSE(Telemetry_read(&reader, 2U, &data));
+}
+
+TEST_F(TelemetryTest, SequenceWraps) {
+    /* The sequence of a record wraps through zero after 2^31 publications, the record stays
+     * readable. */
+    Telemetry_Record *record = (Telemetry_Record *)(void *)((uint8_t *)writer.base + 64U);
+    Telemetry_Data data {};
+    Telemetry_Data published = make_data(7U);
+    Telemetry_publish(&writer, 0U, &published);
+    record->seq = 0xFFFFFFFEU;
+
+    published = make_data(8U);
+    Telemetry_publish(&writer, 0U, &published);
+    ASSERT_EQ(record->seq, 0U);
+    ASSERT_TRUE(Telemetry_read(&reader, 0U, &data));
+    EXPECT_EQ(data.cycle, 8U);
+
+    published = make_data(9U);
+    Telemetry_publish(&writer, 0U, &published);
+    ASSERT_TRUE(Telemetry_read(&reader, 0U, &data));
+    EXPECT_EQ(data.cycle, 9U);
+}
+
+TEST_F(TelemetryTest, SecondWriterFails) {
+    /* The running writer keeps its segment, its readers stay attached to it. */
+    Telemetry second;
+    EXPECT_EQ(Telemetry_create(&second, name.c_str(), 2U), -EEXIST);
+    Telemetry_close(&second);
+
+    Telemetry_Data published = make_data(5U);
+    Telemetry_Data data;
+    Telemetry_publish(&writer, 0U, &published);
+    ASSERT_TRUE(Telemetry_read(&reader, 0U, &data));
+    EXPECT_EQ(data.cycle, 5U);
+}
+
+TEST_F(TelemetryTest, RemoveStaleSegment) {
+    /* A writer which did not close its segment left it behind. */
+    EXPECT_EQ(Telemetry_remove(name.c_str()), 0);
+    EXPECT_EQ(Telemetry_remove(name.c_str()), -ENOENT);
+
+    Telemetry replacement;
+    ASSERT_EQ(Telemetry_create(&replacement, name.c_str(), 1U), 0);
+    EXPECT_EQ(replacement.record_count, 1U);
+    Telemetry_close(&replacement);
+}
+
+TEST_F(TelemetryTest, OpenMissingSegment) {
+    Telemetry missing;
+    EXPECT_LT(Telemetry_open(&missing, "/elevator_test_missing_segment"), 0);
+    EXPECT_FALSE(Telemetry_read(&missing, 0U, nullptr));
+}
+
+TEST_F(TelemetryTest, ConcurrentReadsAreConsistent) {
+    std::atomic<bool> done {false};
+
+    std::thread writer_thread([&]() {
+        for (uint64_t cycle = 1U; cycle <= 2000000U; cycle++) {
+            Telemetry_Data data = make_data(cycle);
+            Telemetry_publish(&writer, 0U, &data);
+        }
+        done = true;
+    });
+
+    unsigned snapshots = 0U;
+    uint64_t last_cycle = 0U;
+    while (!done.load()) {
+        Telemetry_Data data {};
+        if (Telemetry_read(&reader, 0U, &data)) {
+            Telemetry_Data expected = make_data(data.cycle);
+            ASSERT_EQ(data.pending_calls, expected.pending_calls);
+            ASSERT_EQ(data.pc, expected.pc);
+            ASSERT_EQ(data.floor, expected.floor);
+            ASSERT_EQ(data.door, expected.door);
+            ASSERT_EQ(data.movement, expected.movement);
+            ASSERT_GE(data.cycle, last_cycle);
+            last_cycle = data.cycle;
+            snapshots++;
+        }
+    }
+    writer_thread.join();
+
+    EXPECT_GT(snapshots, 0U);
+}
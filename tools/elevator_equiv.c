@@ -0,0 +1,276 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "equiv.h"
+#include "seqnet.h"
+
+/* Name of the built-in program on the command line. */
+#define BUILTIN_NAME  "builtin"
+
+/* Longest line of an image file. */
+#define LINE_SIZE     256U
+
+/**
+ * @brief Loads a program image.
+ *
+ * The file holds instruction words in hex, assigned to consecutive addresses from 0. An "ADDR:"
+ * token (hex) moves the address, '#' starts a comment. Unset words are 0.
+ *
+ * @param[in]  path   File name, or BUILTIN_NAME for the built-in program.
+ * @param[out] image  Receives the program image.
+ * @return 0 on success, a negative errno value otherwise.
+ */
+static int load_image(const char *path, uint16_t image[SEQNET_PROG_MEM_SIZE])
+{
+    if (strcmp(path, BUILTIN_NAME) == 0)
+    {
+        memcpy(image, SeqNet_program(), SEQNET_PROG_MEM_SIZE * sizeof(uint16_t));
+        return 0;
+    }
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+    {
+        return -errno;
+    }
+
+    memset(image, 0, SEQNET_PROG_MEM_SIZE * sizeof(uint16_t));
+
+    char line[LINE_SIZE];
+    unsigned long address = 0UL;
+    int error = 0;
+
+    while ((error == 0) && (fgets(line, sizeof(line), file) != NULL))
+    {
+        char *comment = strchr(line, '#');
+        if (comment != NULL)
+        {
+            *comment = '\0';
+        }
+
+        for (char *token = strtok(line, " \t\r\n,"); token != NULL; token = strtok(NULL, " \t\r\n,"))
+        {
+            char *end;
+            unsigned long value = strtoul(token, &end, 16);
+
+            if ((end != token) && (strcmp(end, ":") == 0) && (value < SEQNET_PROG_MEM_SIZE))
+            {
+                address = value;
+            }
+            else if ((end != token) && (*end == '\0') && (value <= 0xFFFFUL) && (address < SEQNET_PROG_MEM_SIZE))
+            {
+                image[address++] = (uint16_t)value;
+            }
+            else
+            {
+                error = -EILSEQ;
+                break;
+            }
+        }
+    }
+
+    (void)fclose(file);
+    return error;
+}
+
+/**
+ * @brief Prints the built-in program in the image file format.
+ */
+static void dump_builtin(void)
+{
+    const uint16_t *image = SeqNet_program();
+
+    printf("# Built-in program of seqnet.c\n");
+    for (unsigned address = 0U; address < SEQNET_PROG_MEM_SIZE; address++)
+    {
+        if (image[address] != 0U)
+        {
+            printf("%02X: %04X\n", address, image[address]);
+        }
+    }
+}
+
+/**
+ * @brief Formats a packed sensor word, one letter per active input.
+ */
+static const char *format_sensors(const uint8_t sensors, char text[8])
+{
+    static const char letters[7] = {'b', 's', 'a', 'C', 'O', 'E', 'D'};
+
+    for (unsigned bit = 0U; bit < 7U; bit++)
+    {
+        text[bit] = ((sensors & (1U << bit)) != 0U) ? letters[bit] : '-';
+    }
+    text[7] = '\0';
+    return text;
+}
+
+/**
+ * @brief Formats the requests of an instruction, one letter per active request.
+ */
+static const char *format_requests(const uint8_t requests, char text[5])
+{
+    static const char letters[4] = {'U', 'D', 'O', 'R'};
+
+    for (unsigned bit = 0U; bit < 4U; bit++)
+    {
+        text[bit] = ((requests & (1U << bit)) != 0U) ? letters[bit] : '-';
+    }
+    text[4] = '\0';
+    return text;
+}
+
+/**
+ * @brief Prints the length of a reaction, nothing in lockstep.
+ */
+static void print_cycles(const uint8_t stretch, const uint8_t cycles)
+{
+    if (stretch == 0U)
+    {
+        return;
+    }
+
+    if (cycles != 0U)
+    {
+        printf(" +%-3u", (unsigned)cycles);
+    }
+    else
+    {
+        printf(" wait");
+    }
+}
+
+/**
+ * @brief Replays the counterexample on both programs and prints every step.
+ */
+static void print_trace(const uint16_t *a, const uint16_t *b, const uint8_t stretch, const Equiv_Result *result)
+{
+    Equiv_Machine machine_a;
+    Equiv_Machine machine_b;
+    Equiv_init(&machine_a);
+    Equiv_init(&machine_b);
+
+    printf("Counterexample, %u steps (sensors: b/s/a call below/same/above, C/O door closed/open, "
+           "E/D elevator/door position ok; requests: U/D move up/down, O door open, R reset call):\n",
+           (unsigned)result->length);
+    int width = (stretch != 0U) ? 12 : 7;
+    printf("%5s  %-7s  %-*s  %-*s\n", "step", "sensors", width, "A pc/req", width, "B pc/req");
+
+    for (uint32_t step = 0U; step < result->length; step++)
+    {
+        uint8_t sensors = result->trace[step];
+        uint8_t output_a;
+        uint8_t output_b;
+        uint8_t cycles_a = Equiv_react(a, &machine_a, sensors, stretch, &output_a);
+        uint8_t cycles_b = Equiv_react(b, &machine_b, sensors, stretch, &output_b);
+        char text_sensors[8];
+        char text_a[5];
+        char text_b[5];
+
+        printf("%5u  %-7s  %02X %-4s", (unsigned)step, format_sensors(sensors, text_sensors),
+               machine_a.pc, format_requests(output_a, text_a));
+        print_cycles(stretch, cycles_a);
+        printf("  %02X %-4s", machine_b.pc, format_requests(output_b, text_b));
+        print_cycles(stretch, cycles_b);
+        printf("\n");
+    }
+}
+
+static void print_usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [--stretch N] [--threads N] A B\n"
+            "       %s --dump\n"
+            "  Checks that the program images A and B produce the same requests for every input sequence.\n"
+            "  A and B are image files (hex words, \"ADDR:\" moves the address, '#' comments)\n"
+            "  or \"" BUILTIN_NAME "\" for the program of seqnet.c.\n"
+            "  --stretch N  Hold every input until both programs reacted within N cycles (default: lockstep)\n"
+            "  --threads N  Worker threads (default: 4)\n"
+            "  --dump       Print the built-in program as an image file\n",
+            name, name);
+}
+
+int main(int argc, char *argv[])
+{
+    Equiv_Config config = {0U, 4U};
+    const char *paths[2] = {NULL, NULL};
+    unsigned path_count = 0U;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--dump") == 0)
+        {
+            dump_builtin();
+            return 0;
+        }
+        else if (((strcmp(argv[i], "--stretch") == 0) || (strcmp(argv[i], "--threads") == 0)) && ((i + 1) < argc))
+        {
+            char *end;
+            unsigned long value = strtoul(argv[i + 1], &end, 10);
+            unsigned long limit = (argv[i][2] == 's') ? 255UL : EQUIV_MAX_THREADS;
+            if ((*end != '\0') || (value > limit))
+            {
+                print_usage(argv[0]);
+                return 2;
+            }
+            if (argv[i][2] == 's')
+            {
+                config.stretch = (uint8_t)value;
+            }
+            else
+            {
+                config.threads = (uint8_t)value;
+            }
+            i++;
+        }
+        else if ((argv[i][0] != '-') && (path_count < 2U))
+        {
+            paths[path_count++] = argv[i];
+        }
+        else
+        {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (path_count != 2U)
+    {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    static uint16_t images[2][SEQNET_PROG_MEM_SIZE];
+    for (unsigned i = 0U; i < 2U; i++)
+    {
+        int status = load_image(paths[i], images[i]);
+        if (status != 0)
+        {
+            fprintf(stderr, "Cannot load %s: %s\n", paths[i], strerror(-status));
+            return 2;
+        }
+    }
+
+    Equiv_Result result;
+    int status = Equiv_check(images[0], images[1], &config, &result);
+    if (status != 0)
+    {
+        fprintf(stderr, "Check failed: %s\n", strerror(-status));
+        return 2;
+    }
+
+    printf("%u product states explored (%s)\n", (unsigned)result.states,
+           (config.stretch == 0U) ? "lockstep" : "stretching");
+
+    if (!result.equivalent)
+    {
+        printf("NOT EQUIVALENT\n");
+        print_trace(images[0], images[1], config.stretch, &result);
+        Equiv_free(&result);
+        return 1;
+    }
+
+    printf("Equivalent\n");
+    return 0;
+}
@@ -0,0 +1,185 @@
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "elevator_abi.h"
+#include "hil.h"
+#include "plant.h"
+
+/* Defaults of the command line. */
+#define DEFAULT_CARS           16U
+#define DEFAULT_CYCLES         10000U
+#define DEFAULT_FLOORS         6U
+
+/* Control cycle, the plant is integrated with the same step. */
+#define PLANT_DT               0.01f
+
+/* Mean number of control cycles between two calls of a car. */
+#define CALL_INTERVAL          500U
+
+/**
+ * @brief Parses an unsigned integer option value.
+ * @param text The text to parse.
+ * @param value Receives the value.
+ * @return True if the whole text is a valid number.
+ */
+static bool parse_number(const char *text, unsigned long *value)
+{
+    char *end = NULL;
+
+    if ((text == NULL) || (*text == '\0'))
+    {
+        return false;
+    }
+
+    *value = strtoul(text, &end, 10);
+    return *end == '\0';
+}
+
+static void print_usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s ADDRESS [--cars N] [--cycles N] [--floors N]\n"
+            "  Stand-in plant for the gateway of \"elevator_emulator --hil ADDRESS\".\n"
+            "  Simulates the cars, posts random calls and exchanges the sensor and instruction\n"
+            "  words with the gateway every tick, then prints the round trip times.\n"
+            "  ADDRESS      unix:PATH or shm:NAME (e.g. shm:/elevator_hil)\n"
+            "  --cars N     number of cars, at most %u (default: %u)\n"
+            "  --cycles N   number of ticks (default: %u)\n"
+            "  --floors N   floors of the building (default: %u)\n",
+            name, HIL_MAX_CARS, DEFAULT_CARS, DEFAULT_CYCLES, DEFAULT_FLOORS);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *address = NULL;
+    unsigned long cars = DEFAULT_CARS;
+    unsigned long cycles = DEFAULT_CYCLES;
+    unsigned long floors = DEFAULT_FLOORS;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool has_value = (i + 1) < argc;
+
+        if (has_value && (strcmp(argv[i], "--cars") == 0) && parse_number(argv[i + 1], &cars) &&
+            (cars > 0UL) && (cars <= HIL_MAX_CARS))
+        {
+            i++;
+        }
+        else if (has_value && (strcmp(argv[i], "--cycles") == 0) && parse_number(argv[i + 1], &cycles))
+        {
+            i++;
+        }
+        else if (has_value && (strcmp(argv[i], "--floors") == 0) && parse_number(argv[i + 1], &floors) &&
+                 (floors > 1UL) && (floors <= 8UL))
+        {
+            i++;
+        }
+        else if ((argv[i][0] != '-') && (address == NULL))
+        {
+            address = argv[i];
+        }
+        else
+        {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (address == NULL)
+    {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    Plant plant;
+    Plant_Config config;
+    Plant_default_config(&config, (uint8_t)floors);
+    if (Plant_create(&plant, (uint32_t)cars, &config) != 0)
+    {
+        fprintf(stderr, "Plant_create failed\n");
+        return 1;
+    }
+
+    HIL_Link link;
+    static HIL_Stats stats;
+    int result = HIL_connect(&link, address, HIL_TIMEOUT_MS);
+    if (result == 0)
+    {
+        result = HIL_hello(&link, (uint32_t)cars, &stats);
+    }
+    if (result != 0)
+    {
+        fprintf(stderr, "Connecting to %s failed: %s\n", address, strerror(-result));
+        HIL_close(&link);
+        Plant_destroy(&plant);
+        return 1;
+    }
+
+    uint32_t calls[HIL_MAX_CARS] = {0U};
+    uint8_t sensors[HIL_MAX_CARS];
+    uint16_t outputs[HIL_MAX_CARS];
+    uint32_t seed = 1U;
+    uint64_t served = 0U;
+
+    for (uint64_t tick = 0U; (tick < cycles) && (result == 0); tick++)
+    {
+        for (uint32_t car = 0U; car < cars; car++)
+        {
+            seed = (seed * 1103515245U) + 12345U;
+            if (((seed >> 16) % CALL_INTERVAL) == 0U)
+            {
+                calls[car] |= 1U << ((seed >> 8) % floors);
+            }
+            sensors[car] = Plant_sense(&plant, car, calls[car]);
+        }
+
+        result = HIL_exchange(&link, tick, sensors, outputs, (uint32_t)cars, &stats);
+        if (result != 0)
+        {
+            break;
+        }
+
+        for (uint32_t car = 0U; car < cars; car++)
+        {
+            if (((outputs[car] & ELEV_OUT_RESET_CALL) != 0U) && Plant_is_level(&plant, car))
+            {
+                uint32_t bit = 1U << Plant_floor(&plant, car);
+                served += ((calls[car] & bit) != 0U) ? 1U : 0U;
+                calls[car] &= ~bit;
+            }
+            Plant_command(&plant, car, outputs[car]);
+        }
+
+        Plant_step(&plant, PLANT_DT);
+    }
+
+    if (result == 0)
+    {
+        result = HIL_bye(&link);
+    }
+    HIL_close(&link);
+    Plant_destroy(&plant);
+
+    if (result != 0)
+    {
+        fprintf(stderr, "Session with %s failed after %llu ticks: %s\n", address,
+                (unsigned long long)stats.ticks, strerror(-result));
+        return 1;
+    }
+
+    printf("Ticks=%llu, Cars=%lu, Served calls=%llu\n", (unsigned long long)stats.ticks, cars,
+           (unsigned long long)served);
+    if (stats.rtt.total != 0U)
+    {
+        printf("Round trip: min=%llu p50=%llu p99=%llu p99.9=%llu max=%llu (ns)\n",
+               (unsigned long long)stats.rtt.min,
+               (unsigned long long)Histo_percentile(&stats.rtt, 50.0),
+               (unsigned long long)Histo_percentile(&stats.rtt, 99.0),
+               (unsigned long long)Histo_percentile(&stats.rtt, 99.9),
+               (unsigned long long)stats.rtt.max);
+    }
+
+    return 0;
+}
@@ -0,0 +1,42 @@
+#include <stdio.h>
+#include <string.h>
+#include "recorder.h"
+#include "../bench/bench_clock.h"
+
+int main(int argc, char *argv[])
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: %s FILE\n  Replays a recording of elevator_emulator --record and verifies the outputs.\n", argv[0]);
+        return 2;
+    }
+
+    Recorder_Result result;
+    double start = bench_now_ns();
+    int status = Recorder_replay(argv[1], &result);
+    double elapsed = (bench_now_ns() - start) * 1e-9;
+
+    if (status != 0)
+    {
+        fprintf(stderr, "Replay of %s failed after %llu cycles: %s\n",
+                argv[1], (unsigned long long)result.cycles, strerror(-status));
+        return 1;
+    }
+
+    printf("Replayed %llu cycles in %llu runs (%llu resets) in %.3f s\n",
+           (unsigned long long)result.cycles,
+           (unsigned long long)result.runs,
+           (unsigned long long)result.resets,
+           elapsed);
+
+    if (result.mismatches != 0U)
+    {
+        printf("MISMATCH: %llu runs differ, first at cycle %llu\n",
+               (unsigned long long)result.mismatches,
+               (unsigned long long)result.first_mismatch);
+        return 1;
+    }
+
+    printf("Outputs match the recording\n");
+    return 0;
+}
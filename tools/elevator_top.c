@@ -0,0 +1,112 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "telemetry.h"
+
+/* Defaults of the sampling. */
+#define DEFAULT_NAME         "/elevator"
+#define DEFAULT_INTERVAL_MS  200UL
+
+/* Number of floors shown in the call map. */
+#define SHOWN_FLOORS         8U
+
+/**
+ * @brief Sleeps for the given time.
+ * @param ms Time to sleep in milliseconds.
+ */
+static void sleep_ms(unsigned long ms)
+{
+    struct timespec ts;
+    ts.tv_sec = (time_t)(ms / 1000UL);
+    ts.tv_nsec = (long)((ms % 1000UL) * 1000000UL);
+    (void)nanosleep(&ts, NULL);
+}
+
+/**
+ * @brief Prints a snapshot of a car.
+ * @param record Index of the record.
+ * @param data The snapshot.
+ */
+static void print_record(uint32_t record, const Telemetry_Data *data)
+{
+    static const char *const movements[] = {"Stopped", "Up     ", "Down   "};
+    char calls[SHOWN_FLOORS + 1U];
+
+    for (uint8_t k = 0U; k < SHOWN_FLOORS; k++)
+    {
+        calls[k] = ((data->pending_calls >> k) & 1U) ? '1' : '0';
+    }
+    calls[SHOWN_FLOORS] = '\0';
+
+    printf("car %u: cycle=%llu PC=%3u Floor=%u Movement=%s Door=%s Calls=%s\n",
+           record,
+           (unsigned long long)data->cycle,
+           data->pc,
+           data->floor,
+           (data->movement <= TELEMETRY_MOVEMENT_DOWN) ? movements[data->movement] : "?      ",
+           (data->door == TELEMETRY_DOOR_OPEN) ? "Open  " : "Closed",
+           calls);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *name = DEFAULT_NAME;
+    unsigned long interval_ms = DEFAULT_INTERVAL_MS;
+    unsigned long samples = 0UL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (((i + 1) < argc) && (strcmp(argv[i], "--interval-ms") == 0))
+        {
+            interval_ms = strtoul(argv[++i], NULL, 10);
+        }
+        else if (((i + 1) < argc) && (strcmp(argv[i], "--samples") == 0))
+        {
+            samples = strtoul(argv[++i], NULL, 10);
+        }
+        else if (argv[i][0] != '-')
+        {
+            name = argv[i];
+        }
+        else
+        {
+            fprintf(stderr,
+                    "Usage: %s [NAME] [--interval-ms N] [--samples N]\n"
+                    "  NAME            shared memory object of elevator_emulator --telemetry (default: %s)\n"
+                    "  --interval-ms N sampling interval (default: %lu)\n"
+                    "  --samples N     stop after N samples (default: run until interrupted)\n",
+                    argv[0], DEFAULT_NAME, DEFAULT_INTERVAL_MS);
+            return 2;
+        }
+    }
+
+    Telemetry telemetry;
+    int result = Telemetry_open(&telemetry, name);
+    if (result != 0)
+    {
+        fprintf(stderr, "Cannot open telemetry segment %s: %s\n", name, strerror(-result));
+        return 1;
+    }
+
+    for (unsigned long sample = 0UL; (samples == 0UL) || (sample < samples); sample++)
+    {
+        for (uint32_t record = 0U; record < telemetry.record_count; record++)
+        {
+            Telemetry_Data data;
+            if (Telemetry_read(&telemetry, record, &data))
+            {
+                print_record(record, &data);
+            }
+            else
+            {
+                printf("car %u: no data\n", record);
+            }
+        }
+        fflush(stdout);
+        sleep_ms(interval_ms);
+    }
+
+    Telemetry_close(&telemetry);
+    return 0;
+}